@@ -0,0 +1,9 @@
+/* Instruction clock. INIT_CLOCK() in PIC24FStarter.h runs the 12 MHz
+ * crystal through the 96 MHz PLL to a 32 MHz Fosc, two clocks an
+ * instruction. Timer periods, baud rates and bus timing derive from this. */
+#ifndef CLOCK__H
+#define	CLOCK__H
+
+#define FCY 16000000UL
+
+#endif
@@ -0,0 +1,92 @@
+/* Text and shape helpers of the user interface. Everything is drawn into the
+ * SH1101A shadow framebuffer and goes out with the next FlushDevice(). */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Graphics.h"
+#include "Font5x7.h"
+
+#define FONT_CELL_MASK 0x7F  // glyphs use the top 7 rows of their page byte
+bool uiOpaqueText = false;  // true: text also clears its background cell
+
+// Bresenham's Line Algorithm. Pixels are collected into runs along the major
+// axis, each run (a row for shallow lines, a column for steep ones) is one
+// HLine/VLine; axis-aligned lines are a single run.
+void GFX_DrawLine(int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy, e2;
+    bool shallow = dx >= -dy;
+    int runX = x0, runY = y0;  // first pixel of the current run
+
+    if (y0 == y1) { HLine(x0, x1, y0); return; }
+    if (x0 == x1) { VLine(x0, y0, y1); return; }
+    for (;;) {
+        int px = x0, py = y0;
+        bool last = (x0 == x1 && y0 == y1);
+        if (!last) {
+            e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+        // close the run when the next pixel leaves its row / column
+        if (last || (shallow ? y0 != py : x0 != px)) {
+            if (shallow) HLine(runX, px, py); else VLine(px, runY, py);
+            runX = x0; runY = y0;
+        }
+        if (last) break;
+    }
+}
+
+// Draw Node (Hollow or Filled)
+void GFX_DrawNode(uint8_t x, uint8_t y, bool filled) {
+    // Draw Node Outline (Cross-like shape)
+    PutPixel(x, y-3); PutPixel(x, y+3);
+    PutPixel(x-3, y); PutPixel(x+3, y);
+    PutPixel(x-1, y-2); PutPixel(x+1, y-2);
+    PutPixel(x-2, y-1); PutPixel(x+2, y-1);
+    PutPixel(x-2, y+1); PutPixel(x+2, y+1);
+    PutPixel(x-1, y+2); PutPixel(x+1, y+2);
+
+    if (filled) {
+        PutPixel(x, y);
+        PutPixel(x-1, y); PutPixel(x+1, y);
+        PutPixel(x, y-1); PutPixel(x, y+1);
+    }
+}
+
+// Draw a single character from the font array. Font columns are one byte
+// each, like a display page, so every column is a single PutColumn().
+// In opaque mode the 6x7 cell is cleared too, old text needs no erase.
+void UI_DrawChar(int x, int y, char c) { 
+    // Cast to unsigned to handle extended ASCII (128-255) safely
+    uint8_t uc = (uint8_t)c;
+    
+    // Check range: 32 (Space) to 129 ()
+    if (uc < 32 || uc > 129) uc = 32; 
+    
+    int index = uc - 32; 
+    
+    for (int i = 0; i < 5; i++) { 
+        uint8_t line = Font5x7[index][i]; 
+        PutColumn(x + i, y, line, uiOpaqueText ? FONT_CELL_MASK : line);
+    } 
+    if (uiOpaqueText) PutColumn(x + 5, y, 0, FONT_CELL_MASK);  // spacing
+}
+
+// Draw a string of text
+void UI_DrawString(int x, int y, char* str) {
+    while (*str) {
+        UI_DrawChar(x, y, *str);
+        x += 6; // 5px width + 1px spacing
+        str++;
+    }
+}
+
+void UI_PrintNum(int x, int y, int num, bool leadingZero) {
+    char buf[5];
+    if (leadingZero)
+        sprintf(buf, "%02d", num);
+    else
+        sprintf(buf, "%d", num);
+    UI_DrawString(x, y, buf);
+}
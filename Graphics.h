@@ -0,0 +1,18 @@
+/* Text and shape helpers of the user interface, drawn with the SH1101A
+ * primitives. Text uses the 5x7 font in 6 pixel wide cells. */
+#ifndef GRAPHICS_H
+#define GRAPHICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SH1101A.h"
+
+extern bool uiOpaqueText;  // true: text also clears its background cell
+
+void GFX_DrawLine(int x0, int y0, int x1, int y1);
+void GFX_DrawNode(uint8_t x, uint8_t y, bool filled);
+void UI_DrawChar(int x, int y, char c);
+void UI_DrawString(int x, int y, char* str);
+void UI_PrintNum(int x, int y, int num, bool leadingZero);
+
+#endif
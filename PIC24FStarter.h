@@ -29,9 +29,14 @@
 
 #include "SH1101A.h"
 #include "TouchSense.h"
+#include "TouchInput.h"
 #include "RGBLeds.h"
+#include "Scheduler.h"
 #include "Font5x7.h"
+#include "Graphics.h"
 #include "languages.h"
+#include "screens.h"
+#include "icons.h"
 
 #define INIT_CLOCK() OSCCON = 0x3302; CLKDIV = 0x0000;
 
@@ -4,17 +4,46 @@
 #include "SH1101A.h"
 
 uint8_t _color;
+uint8_t _frame[DISP_PAGES][DISP_COLUMNS];  // back buffer, drawn into
+uint8_t _front[DISP_PAGES][DISP_COLUMNS];  // what the controller RAM holds
+uint8_t frontValid;                        // _front is meaningless after reset
+uint32_t _pmpBytes;                          // PMP transfers, for profiling
+uint32_t _flushCompared, _flushSent, _flushSetups;  // diff flush statistics
+
+// first and last dirty column per page; first > last means page is clean
+uint8_t dirtyLo[DISP_PAGES], dirtyHi[DISP_PAGES];
+
+// display start line: screen row 0 shows this RAM row, the rest wraps around
+uint8_t startLine, startLinePending;
+
+// Background flush: FlushDevice() latches the dirty ranges into a job of
+// runs, the PMP interrupt then sends one byte at the end of every PMP cycle.
+// Within a run only the stretches that differ from _front go out.
+typedef struct {
+    uint8_t page, lo, hi;   // page and first/last column to compare
+} FlushRun;
+FlushRun flushRuns[DISP_PAGES];
+uint8_t flushRunCount, flushRun, flushStep, flushCol, flushEnd, flushStartLine;
+uint8_t flushPaged;  // page command of the current run already sent
+uint8_t flushDiff;   // compare against _front, else send the runs whole
+
+// Jumping ahead within a page costs the lower and higher column command, so
+// up to this many unchanged bytes between two changes are sent along.
+#define FLUSH_SETUP_BYTES   2
+volatile uint8_t _flushBusy;     // a job is in flight
 
 // sets page + lower and higher address pointer of display buffer
 #define SetAddress(page, lowerAddr, higherAddr) \
 	DisplaySetCommand(); DeviceWrite(page); DeviceWrite(lowerAddr); \
     DeviceWrite(higherAddr); DisplaySetData();
 
-#define AssignPageAddress(y) \
-    if (y < 8) page = 0xB0; else if (y < 16) page = 0xB1; \
-    else if (y < 24) page = 0xB2; else if (y < 32) page = 0xB3; \
-    else if (y < 40) page = 0xB4; else if (y < 48) page = 0xB5; \
-    else if (y < 56) page = 0xB6; else page = 0xB7
+// RAM row that is currently shown at screen row y
+#define RamRow(y)   (((y) + startLine) & (DISP_VER_RESOLUTION - 1))
+
+// widens the dirty column range of a page to include column col
+#define MarkDirty(page, col) \
+    if ((col) < dirtyLo[page]) dirtyLo[page] = (col); \
+    if ((col) > dirtyHi[page]) dirtyHi[page] = (col)
 
 #define PMPWaitBusy()   while(PMMODEbits.BUSY)  // wait for PMP cycle end
 
@@ -48,17 +77,19 @@ void DelayMs( uint16_t ms ) {
 
 // write data into controller's RAM, chip select should be enabled
 extern inline void __attribute__ ((always_inline)) DeviceWrite(uint8_t data) {
-	PMDIN1 = data;
+	PMPWrite(data);
 	PMPWaitBusy();
+    _pmpBytes++;
 }
 
 // read data from controller's RAM. chip select should be enabled
 extern inline uint8_t __attribute__ ((always_inline)) DeviceRead() {
     uint8_t value;
-	value = PMDIN1;
+	value = PMPRead();
 	PMPWaitBusy();
+    _pmpBytes++;
 	PMCONbits.PMPEN = 0; // disable PMP
-	value = PMDIN1;
+	value = PMPRead();
 	PMCONbits.PMPEN = 1; // enable  PMP
 	return value;
 }
@@ -66,23 +97,31 @@ extern inline uint8_t __attribute__ ((always_inline)) DeviceRead() {
 // single read is performed; Useful in issuing one read access only.
 extern inline uint8_t __attribute__ ((always_inline)) SingleDeviceRead() {
     uint8_t value;
-	value = PMDIN1;
+	value = PMPRead();
 	PMPWaitBusy();
+    _pmpBytes++;
 	return value;
 }
 
 // Reads a word from the device
 extern inline uint16_t __attribute__ ((always_inline)) DeviceReadWord() {
     uint16_t value; uint8_t temp;
-    value = PMDIN1;
+    value = PMPRead();
     value = value << 8;
     PMPWaitBusy();
-    temp = PMDIN1;
+    temp = PMPRead();
     value = value & temp;
     PMPWaitBusy();
     return value;
 }
 
+// marks every column of every page for the next FlushDevice()
+static void MarkAllDirty(void) {
+    for (uint8_t p = 0; p < DISP_PAGES; p++) {
+        dirtyLo[p] = 0; dirtyHi[p] = DISP_COLUMNS - 1;
+    }
+}
+
 // initializes the OLED device
 extern inline void __attribute__ ((always_inline)) DriverInterfaceInit(void) { 
     // variable for PMP timing calculation
@@ -114,6 +153,8 @@ extern inline void __attribute__ ((always_inline)) DriverInterfaceInit(void) {
             PMMODEbits.WAITE = (PMP_DATA_HOLD_TIME / pClockPeriod) + 1;
     #endif
     PMMODEbits.MODE16 = 0;              // 8 bit mode
+    PMMODEbits.IRQM = 1;                // interrupt at end of each cycle
+    IPC11bits.PMPIP = 1;                // lowest priority: touch goes first
     PMCONbits.PTRDEN =  PMCONbits.PTWREN = 1;  // enable WR & RD line
     PMCONbits.PMPEN = 1;                // enable PMP
     DisplayResetDisable();              // release from reset
@@ -147,65 +188,249 @@ void ResetDevice(void) {
     DelayMs(150);
     DeviceWrite(0xA4);             // Entire Display ON/OFF: A4=ON
     DeviceWrite(0x40);             // Set display start line
+    startLine = startLinePending = 0;
+    frontValid = 0;
     DeviceWrite(0x00 + OFFSET);    // Set lower column address
     DeviceWrite(0x10);             // Set higher column address
     DelayMs(1);
     DisplayDisable(); DisplaySetData();
+    MarkAllDirty();  // controller RAM is undefined after reset
 }
 
-// puts pixel
+// puts pixel into the shadow buffer, clipped to the visible area
 void PutPixel(int16_t x, int16_t y) {
-    uint8_t page, add, lAddr, hAddr;
-    uint8_t mask, display;
-    // Assign a page address
-    AssignPageAddress(y);
-    add = x + OFFSET;
-    lAddr = 0x0F & add; hAddr = 0x10 | (add >> 4);  // low + high address
-    // Calculate mask from rows basically do a y%8 and remainder is bit position
-    add = y >> 3;                   // Divide by 8
-    add <<= 3;                      // Multiply by 8
-    add = y - add;                  // Calculate bit position
-    mask = 1 << add;                // Left shift 1 by bit position
-    DisplayEnable();
-    SetAddress(page, lAddr, hAddr); // Set the address (sets the page,
-    // lower and higher column address pointers)
-    display = SingleDeviceRead();	// initiate Read transaction on PMP  								
-    display = SingleDeviceRead();	// for synchronization in the controller
-    display = SingleDeviceRead();	// read actual data from display buffer
-    if (_color > 0)  display |= mask;   // pixel on -> or in mask
-    else display &= ~mask;           //    pixel off -> and with inverted mask
-    SetAddress(page, lAddr, hAddr); // Set the address (sets the page,
-    // lower and higher column address pointers)
-    DeviceWrite(display);             // restore the byte with manipulated bit
-    DisplayDisable();
-}
-
-// return pixel color at x,y position
+    uint8_t page, col, mask, row;
+    if (x < 0 || x >= DISP_HOR_RESOLUTION || y < 0 || y >= DISP_VER_RESOLUTION)
+        return;
+    col = x + OFFSET;
+    row = RamRow(y);
+    page = row >> 3;                // 8 rows per page
+    mask = 1 << (row & 7);          // bit position inside the page byte
+    if (_color > 0) _frame[page][col] |= mask;   // pixel on -> or in mask
+    else _frame[page][col] &= ~mask;        // pixel off -> and with inverted mask
+    MarkDirty(page, col);
+}
+
+// return pixel color at x,y position, read from the shadow buffer
 uint8_t GetPixel(int16_t x, int16_t y) {
-    uint8_t page, add, lAddr, hAddr, mask, temp, display;
-    AssignPageAddress(y);
-    add = x + OFFSET;
-    lAddr = 0x0F & add; hAddr = 0x10 | (add >> 4); // low + high address
-    // Calculate mask from rows basically do a y%8 and remainder is bit position
-    temp = y >> 3;                  // Divide by 8
-    temp <<= 3;                     // Multiply by 8
-    temp = y - temp;                // Calculate bit position
-    mask = 1 << temp;               // Left shift 1 by bit position
-    DisplayEnable();
-    SetAddress(page, lAddr, hAddr); // set page, lower, higher column address
-    display = SingleDeviceRead();	// Read to initiate Read transaction on PMP
-    display = DeviceRead();         // Read data from display buffer
-    DisplayDisable();
-    return (display & mask);        // mask all other bits and return the result
+    if (x < 0 || x >= DISP_HOR_RESOLUTION || y < 0 || y >= DISP_VER_RESOLUTION)
+        return 0;
+    uint8_t row = RamRow(y);
+    return _frame[row >> 3][x + OFFSET] & (1 << (row & 7));
 }
 
-// clears screen with _color
+// writes the 8 pixels at x, y..y+7 selected by mask (bit 0 is y): set bits
+// of 'bits' take _color, cleared ones the inverse. This is one byte in one
+// page when y is page aligned, otherwise shifted and merged into two pages.
+void PutColumn(int16_t x, int16_t y, uint8_t bits, uint8_t mask) {
+    uint8_t page, col, row;
+    uint16_t b, m;
+    if (x < 0 || x >= DISP_HOR_RESOLUTION || y <= -8 || y >= DISP_VER_RESOLUTION)
+        return;
+    if (_color == 0) bits = ~bits;
+    if (y < 0) {                    // clip the rows above the screen
+        bits >>= -y; mask >>= -y; y = 0;
+    }
+    if (y > DISP_VER_RESOLUTION - 8)  // and the ones below it
+        mask &= 0xFF >> (y - (DISP_VER_RESOLUTION - 8));
+    col = x + OFFSET;
+    row = RamRow(y);
+    page = row >> 3;
+    b = (uint16_t)bits << (row & 7);
+    m = (uint16_t)mask << (row & 7);
+    _frame[page][col] = (_frame[page][col] & ~(uint8_t)m) | ((uint8_t)b & m);
+    MarkDirty(page, col);
+    m >>= 8;
+    if (m) {                        // lower part spills into the next page
+        page = (page + 1) & (DISP_PAGES - 1);
+        _frame[page][col] = (_frame[page][col] & ~(uint8_t)m) | ((b >> 8) & m);
+        MarkDirty(page, col);
+    }
+}
+
+// Applies a fill (or an inversion) to the rectangle x0..x1, y0..y1. Works a
+// page at a time: one mask per page, applied to a contiguous column run.
+static void RectOp(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t invert) {
+    int16_t t;
+    uint8_t row, page, n, mask, c;
+    if (x0 > x1) { t = x0; x0 = x1; x1 = t; }
+    if (y0 > y1) { t = y0; y0 = y1; y1 = t; }
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= DISP_HOR_RESOLUTION) x1 = DISP_HOR_RESOLUTION - 1;
+    if (y1 >= DISP_VER_RESOLUTION) y1 = DISP_VER_RESOLUTION - 1;
+    if (x0 > x1 || y0 > y1) return;
+    x0 += OFFSET; x1 += OFFSET;
+    while (y0 <= y1) {
+        row = RamRow(y0);
+        page = row >> 3;
+        n = 8 - (row & 7);              // rows left in this page
+        if (n > y1 - y0 + 1) n = y1 - y0 + 1;
+        mask = (uint8_t)(0xFF >> (8 - n)) << (row & 7);
+        for (c = x0; c <= x1; c++) {
+            if (invert) _frame[page][c] ^= mask;
+            else if (_color > 0) _frame[page][c] |= mask;
+            else _frame[page][c] &= ~mask;
+        }
+        MarkDirty(page, x0);
+        MarkDirty(page, x1);
+        y0 += n;
+    }
+}
+
+// fills the rectangle between the corners (inclusive) with _color
+void FillRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    RectOp(x0, y0, x1, y1, 0);
+}
+
+// horizontal line from x0 to x1 on row y
+void HLine(int16_t x0, int16_t x1, int16_t y) {
+    RectOp(x0, y, x1, y, 0);
+}
+
+// vertical line from y0 to y1 in column x
+void VLine(int16_t x, int16_t y0, int16_t y1) {
+    RectOp(x, y0, x, y1, 0);
+}
+
+// inverts every pixel of the rectangle between the corners (inclusive)
+void InvertRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    RectOp(x0, y0, x1, y1, 1);
+}
+
+// Draws a run-length coded page image (from scr2c.py or img2c.py) with its
+// top left corner at x, y, opaque and as stored whatever _color is. The
+// stream is decoded straight into the pages in page order, there is never a
+// decompressed copy of the image.
+void DrawImage(int16_t x, int16_t y, const uint8_t *img) {
+    uint8_t width = img[0], col = 0, page = 0, ctl, b = 0, color = _color;
+    uint16_t left = (uint16_t)width * img[1], n;
+    img += 2;
+    _color = WHITE;
+    while (left) {
+        ctl = *img++;
+        if (ctl & 0x80) { n = (ctl & 0x7F) + 2; b = *img++; }  // repeated byte
+        else n = ctl + 1;                                    // literal bytes
+        while (n-- && left) {
+            if (!(ctl & 0x80)) b = *img++;
+            PutColumn(x + col, y + (page << 3), b, 0xFF);
+            if (++col == width) { col = 0; page++; }
+            left--;
+        }
+    }
+    _color = color;
+}
+
+// clears the shadow buffer with _color; sent on the next FlushDevice()
 void ClearDevice(void) {
-    DisplayEnable();
-    for(uint8_t i = 0xB0; i < 0xB8; i++) {  // go through all 8 pages
-        SetAddress(i, 0x00, 0x10);
-        for(uint8_t j = 0; j < 132; j++) // write to all 132 bytes
-            DeviceWrite(_color);
+    for (uint8_t p = 0; p < DISP_PAGES; p++)
+        for (uint8_t c = 0; c < DISP_COLUMNS; c++)
+            _frame[p][c] = _color;
+    MarkAllDirty();
+}
+
+// Scrolls the screen content up by 'rows' (down if negative) by moving the
+// display start line. Nothing is copied: the rows that wrap around to the
+// other edge still show their old content and are for the caller to repaint.
+// Drawing keeps using screen coordinates, the command goes out on the flush.
+void ScrollDevice(int8_t rows) {
+    startLine = (startLine + rows) & (DISP_VER_RESOLUTION - 1);
+    startLinePending = 1;
+}
+
+// Finds the next stretch of the run to send, starting at flushCol, and sets
+// flushCol/flushEnd to it. Returns 0 if nothing in the rest of the run changed.
+static uint8_t FlushSeek(FlushRun *r) {
+    uint8_t p = r->page, c = flushCol, last;
+    if (c > r->hi) return 0;
+    if (!flushDiff) { flushEnd = r->hi; return 1; }
+    for (; c <= r->hi; c++) {
+        _flushCompared++;
+        if (_frame[p][c] != _front[p][c]) break;
     }
-    DisplayDisable();
+    if (c > r->hi) return 0;
+    flushCol = last = c;
+    // extend while the gap to the next change is cheaper than a new address
+    for (c++; c <= r->hi && c - last <= FLUSH_SETUP_BYTES + 1; c++) {
+        _flushCompared++;
+        if (_frame[p][c] != _front[p][c]) last = c;
+    }
+    flushEnd = last;
+    return 1;
+}
+
+// Sends the next byte of the flush job, or ends the job. Called from the
+// PMP interrupt once the previous cycle is over, so no busy waiting.
+static void FlushNext(void) {
+    FlushRun *r;
+    while (flushRun < flushRunCount) {
+        r = &flushRuns[flushRun];
+        switch (flushStep) {
+            case 0:  // address the next changed stretch, or go to the next run
+                if (!FlushSeek(r)) {
+                    flushRun++; flushPaged = 0;
+                    if (flushRun < flushRunCount) flushCol = flushRuns[flushRun].lo;
+                    continue;
+                }
+                _flushSetups++;
+                DisplaySetCommand();
+                if (flushPaged) { PMPWrite(0x0F & flushCol); flushStep = 2; }  // lower column
+                else { PMPWrite(0xB0 | r->page); flushPaged = 1; flushStep = 1; }
+                break;
+            case 1:  PMPWrite(0x0F & flushCol); flushStep = 2; break;         // lower column
+            case 2:  PMPWrite(0x10 | (flushCol >> 4)); flushStep = 3; break;  // higher column
+            case 3:  DisplaySetData(); flushStep = 4;  // first data byte
+                // fall through
+            default:
+                PMPWrite(_front[r->page][flushCol] = _frame[r->page][flushCol]);
+                _flushSent++;
+                if (flushCol++ == flushEnd) flushStep = 0;
+        }
+        _pmpBytes++;
+        return;
+    }
+    if (flushStartLine) {  // after the data, so new rows arrive together
+        DisplaySetCommand();
+        PMPWrite(0x40 | startLine);
+        flushStartLine = 0;
+        _pmpBytes++;
+    } else {
+        IEC2bits.PMPIE = 0;
+        DisplaySetData(); DisplayDisable();
+        _flushBusy = 0;
+    }
+}
+
+void __attribute__((__interrupt__, no_auto_psv)) _PMPInterrupt(void) {
+    IFS2bits.PMPIF = 0;
+    FlushNext();
+}
+
+// Starts sending the dirty column range of each page in the background and
+// returns at once. Bytes that still match what was sent last are skipped
+// where that saves bus cycles. While a job is in flight it does nothing:
+// everything drawn meanwhile stays dirty and goes out with the next call
+// after the job, so any number of frames coalesce into one job.
+void FlushDevice(void) {
+    if (_flushBusy) return;
+    flushRunCount = 0;
+    for (uint8_t p = 0; p < DISP_PAGES; p++) {
+        if (dirtyLo[p] > dirtyHi[p]) continue;  // nothing changed in this page
+        flushRuns[flushRunCount].page = p;
+        flushRuns[flushRunCount].lo = dirtyLo[p];
+        flushRuns[flushRunCount].hi = dirtyHi[p];
+        flushRunCount++;
+        dirtyLo[p] = 0xFF; dirtyHi[p] = 0;
+    }
+    flushStartLine = startLinePending;
+    startLinePending = 0;
+    if (flushRunCount == 0 && !flushStartLine) return;
+    flushDiff = frontValid;  // after a reset everything dirty goes out as is
+    frontValid = 1;
+    flushRun = flushStep = flushPaged = 0;
+    flushCol = flushRuns[0].lo;
+    _flushBusy = 1;
+    DisplayEnable();
+    IEC2bits.PMPIE = 1;
+    IFS2bits.PMPIF = 1;  // the interrupt sends the first byte
 }
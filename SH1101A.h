@@ -8,12 +8,15 @@
 #define	SH1101A__H
 
 #include <xc.h>
+#include "Clock.h"
 
-#define CLOCK_FREQ 12000000
+#define CLOCK_FREQ FCY  // the delays and the PMP wait states count instructions
 
 #define DISP_HOR_RESOLUTION 128
 #define DISP_VER_RESOLUTION 64
 #define DISP_ORIENTATION    0
+#define DISP_COLUMNS        132  // columns of the controller's display RAM
+#define DISP_PAGES          (DISP_VER_RESOLUTION / 8)
          
 // minimum pulse width requirement of CS controlled RD/WR access in SH1101A 
 // is 100 ns,  + 1 cycle in setup and 1 cycle hold (minimum):
@@ -31,12 +34,34 @@
 #define DisplayDisable()        LATDbits.LATD11 = 1
 #define OFFSET  2  // display offset in x direction
 
+// PMP data port. A host build (see host/) defines these before including
+// this file to feed a model of the controller instead.
+#ifndef PMPWrite
+#define PMPWrite(data)  PMDIN1 = (data)
+#define PMPRead()       PMDIN1
+#endif
+
 #define BLACK (uint16_t)0b00000000
 #define WHITE (uint16_t)0b11111111
 
 extern uint8_t _color;
 #define SetColor(color) _color = (color)
 
+// All drawing goes into a RAM shadow of the display, FlushDevice() sends the
+// changed column ranges to the controller from the PMP interrupt while the
+// application keeps running. _flushBusy is set while a job is in flight; a
+// call during a job sends nothing, so the caller has to call FlushDevice()
+// again once it is over, the main loop does on every pass. _pmpBytes counts
+// every PMP cycle.
+// The flush compares against _front, the last frame sent: _flushCompared,
+// _flushSent and _flushSetups count bytes compared, data bytes sent and
+// column address setups, read them before and after a screen change.
+extern uint8_t _frame[DISP_PAGES][DISP_COLUMNS];
+extern uint8_t _front[DISP_PAGES][DISP_COLUMNS];
+extern uint32_t _pmpBytes;
+extern uint32_t _flushCompared, _flushSent, _flushSetups;
+extern volatile uint8_t _flushBusy;
+
 void Delay10us( uint32_t tenMicroSecondCounter );
 void DelayMs( uint16_t ms );
 
@@ -44,5 +69,13 @@ void ResetDevice(void);
 void ClearDevice(void);
 void PutPixel(int16_t x, int16_t y);
 uint8_t GetPixel(int16_t x, int16_t y);
+void PutColumn(int16_t x, int16_t y, uint8_t bits, uint8_t mask);
+void FillRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void HLine(int16_t x0, int16_t x1, int16_t y);
+void VLine(int16_t x, int16_t y0, int16_t y1);
+void InvertRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void DrawImage(int16_t x, int16_t y, const uint8_t *img);
+void FlushDevice(void);
+void ScrollDevice(int8_t rows);
 
 #endif	/* SH1101A__H */
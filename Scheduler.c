@@ -0,0 +1,76 @@
+/* System tick and software timers, see Scheduler.h */
+#include "Scheduler.h"
+
+volatile uint32_t tickMs;  // ms since Tick_Init()
+SoftTimer *timers;         // the running ones
+
+// Timer1 at TICK_HZ, at IPL1 below the touch scanner so it never delays a
+// scan step; a late tick is only counted late
+void Tick_Init(void) {
+    T1CON = 0x0010;  // off, prescale 1:8
+    TMR1 = 0;
+    PR1 = FCY / 8 / TICK_HZ - 1;
+    IPC0bits.T1IP = 1; IFS0bits.T1IF = 0; IEC0bits.T1IE = 1;
+    T1CONbits.TON = 1;
+}
+
+void __attribute__((__interrupt__, no_auto_psv)) _T1Interrupt(void) {
+    IFS0bits.T1IF = 0;
+    tickMs++;
+}
+
+// the 32 bit count takes two reads, so read until it holds still
+uint32_t Tick_Ms(void) {
+    uint32_t t;
+    do t = tickMs; while (t != tickMs);
+    return t;
+}
+
+// Microseconds from the tick and Timer1 (0.5 us per count), for timing code
+uint32_t Tick_Us(void) {
+    uint32_t t;
+    uint16_t sub;
+    do { t = tickMs; sub = TMR1; } while (t != tickMs);
+    return t * 1000 + sub / 2;
+}
+
+static void Unlink(SoftTimer *t) {
+    for (SoftTimer **p = &timers; *p; p = &(*p)->next)
+        if (*p == t) { *p = t->next; break; }
+    t->active = false;
+}
+
+// Runs run() in ms, then every periodMs if that is not 0. Starting a timer
+// that runs already restarts it.
+void Timer_Start(SoftTimer *t, uint16_t ms, uint16_t periodMs, TimerFunc run) {
+    if (!t->active) { t->next = timers; timers = t; t->active = true; }
+    t->due = Tick_Ms() + ms;
+    t->period = periodMs;
+    t->run = run;
+}
+
+void Timer_Stop(SoftTimer *t) {
+    if (t->active) Unlink(t);
+}
+
+bool Timer_Running(const SoftTimer *t) {
+    return t->active;
+}
+
+// Runs the timers that are due, each once. A periodic timer that fell behind
+// skips the runs it missed instead of catching up on them. Timers started
+// by one of the functions run from the next call on.
+void Sched_Run(void) {
+    uint32_t now = Tick_Ms();
+    SoftTimer *t = timers, *next;
+    for (; t; t = next) {
+        next = t->next;
+        if (!t->active || (int32_t)(now - t->due) < 0) continue;
+        if (t->period == 0) Unlink(t);
+        else {
+            t->due += t->period;
+            if ((int32_t)(now - t->due) >= 0) t->due = now + t->period;
+        }
+        t->run();
+    }
+}
@@ -0,0 +1,33 @@
+/* 1 ms system tick and software timers. Timer1 counts the milliseconds, the
+ * timers run from the main loop (Sched_Run()), so their functions may draw,
+ * write flash or change the state like any other code there. */
+#ifndef SCHEDULER__H
+#define	SCHEDULER__H
+
+#include <xc.h>
+#include "Clock.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TICK_HZ 1000
+
+typedef void (*TimerFunc)(void);
+
+// A timer is owned by whoever starts it and linked in while it runs
+typedef struct SoftTimer {
+    uint32_t due;            // tick it runs at next
+    uint16_t period;         // ms between runs, 0 runs once
+    TimerFunc run;
+    bool active;
+    struct SoftTimer *next;
+} SoftTimer;
+
+void Tick_Init(void);
+uint32_t Tick_Ms(void);
+uint32_t Tick_Us(void);
+void Timer_Start(SoftTimer *t, uint16_t ms, uint16_t periodMs, TimerFunc run);
+void Timer_Stop(SoftTimer *t);
+bool Timer_Running(const SoftTimer *t);
+void Sched_Run(void);
+
+#endif	/* SCHEDULER__H */
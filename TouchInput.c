@@ -0,0 +1,205 @@
+/* Turns the pad scans of TouchSense.c into PRESS, RELEASE, HOLD and REPEAT
+ * events. Only one pad is tracked at a time, the one whose signal leads the
+ * others: a touch starts once a pad has led for TOUCH_SETTLE_SCANS scans,
+ * and a finger sliding on to another pad releases the first one as soon as
+ * the new one leads as long. Everything here runs in the main loop. */
+#include "TouchInput.h"
+#include "TouchTrace.h"
+
+uint8_t buttons[NUM_TOUCHPADS];
+uint16_t touchEventsLost;
+
+TouchEvent queue[TOUCH_QUEUE_SIZE];
+uint8_t queueHead, queueTail;
+
+uint32_t nowMs;             // time of the scan being processed
+uint16_t lastTick;          // scan tick nowMs belongs to
+uint16_t msRemainder;       // tick fraction not yet counted in nowMs, x1000
+bool clockStarted;
+
+int8_t activePad = -1;      // pad of the touch in progress, -1 none
+int8_t candidate = -1;      // leading pad waiting to settle
+uint8_t candidateScans;
+uint32_t nextTimeout;       // when the next HOLD or REPEAT is due
+bool holdSent;
+uint16_t repeatMs;          // interval to the REPEAT after the next one
+uint16_t repeatFirst = TOUCH_REPEAT_MS;  // see Touch_SetRepeat()
+uint16_t repeatFastest = TOUCH_REPEAT_MS;
+uint8_t repeatSpeedup;
+
+uint8_t profile = TOUCH_PROFILE_MENU;  // what the application asked for
+bool asleep;                // scanning the wake profile instead
+bool waking;                // the touch that woke us up is still down
+uint32_t lastTouchMs;       // last scan with a pad pressed
+
+static void Emit(uint8_t type, uint8_t pad) {
+    TouchEvent *ev;
+    if ((uint8_t)(queueHead - queueTail) == TOUCH_QUEUE_SIZE) { touchEventsLost++; return; }
+    ev = &queue[queueHead & (TOUCH_QUEUE_SIZE - 1)];
+    ev->type = type; ev->pad = pad; ev->time = nowMs;
+    queueHead++;
+}
+
+// advances the clock to a scan's tick, ticks skipped by overruns included
+static void AdvanceClock(uint16_t tick) {
+    uint32_t elapsed;
+    if (!clockStarted) { lastTick = tick; clockStarted = true; return; }
+    elapsed = (uint32_t)(uint16_t)(tick - lastTick) * 1000 + msRemainder;
+    lastTick = tick;
+    nowMs += elapsed / TOUCH_SCAN_HZ;
+    msRemainder = elapsed % TOUCH_SCAN_HZ;
+}
+
+// Cross-talk: a finger on the center pad also shows on the four around it,
+// and one on those on the center. Takes a share of the other side's signal
+// off each pad.
+static void Compensate(const TouchScan *scan, int16_t *level) {
+    int16_t center = scan->delta[4] > 0 ? scan->delta[4] : 0;
+    int16_t around = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        level[i] = scan->delta[i] > 0 ? scan->delta[i] : 0;
+        if (level[i] > around) around = level[i];
+    }
+    for (uint8_t i = 0; i < 4; i++)
+        level[i] -= ((int32_t)center * TOUCH_CROSSTALK) >> 4;
+    level[4] = center - (((int32_t)around * TOUCH_CROSSTALK) >> 4);
+}
+
+// The pad under the finger: the strongest after cross-talk compensation, if
+// it is pressed and leads the next one by TOUCH_MARGIN_PCT. -1 if no pad is
+// pressed or the lead is too small to tell.
+static int8_t LeadingPad(const TouchScan *scan) {
+    int16_t level[NUM_TOUCHPADS];
+    int16_t best = 0, next = 0;
+    int8_t pad = -1;
+    Compensate(scan, level);
+    for (int8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        if (level[i] > best) { next = best; best = level[i]; pad = i; }
+        else if (level[i] > next) next = level[i];
+    }
+    if (pad < 0 || !(scan->pressed & (1 << pad))) return -1;
+    if ((int32_t)best * 100 < (int32_t)next * TOUCH_MARGIN_PCT) return -1;
+    return pad;
+}
+
+// true if the newest event not taken yet is a REPEAT
+static bool RepeatPending(void) {
+    return queueHead != queueTail
+        && queue[(uint8_t)(queueHead - 1) & (TOUCH_QUEUE_SIZE - 1)].type == TOUCH_REPEAT;
+}
+
+// HOLD, then REPEAT, while the active pad stays down, each REPEAT a bit
+// sooner than the last until they come every repeatFastest ms. A REPEAT the
+// main loop has not caught up with yet stands for the next one too, so the
+// value being scrolled stops where the finger lifts.
+static void HoldRepeat(void) {
+    if ((int32_t)(nowMs - nextTimeout) < 0) return;
+    if (!holdSent) {
+        Emit(TOUCH_HOLD, activePad);
+        holdSent = true;
+        repeatMs = repeatFirst;
+    } else if (!RepeatPending()) Emit(TOUCH_REPEAT, activePad);
+    nextTimeout += repeatMs;
+    if (repeatMs > repeatFastest) {
+        repeatMs -= (uint32_t)repeatMs * repeatSpeedup / 100;
+        if (repeatMs < repeatFastest) repeatMs = repeatFastest;
+    }
+}
+
+// Drops to the wake profile when nothing was touched for TOUCH_IDLE_MS,
+// except during pattern entry. The touch that wakes it up is not passed on.
+// Returns false while that touch is still down.
+static bool Awake(const TouchScan *scan) {
+    if (scan->pressed) lastTouchMs = nowMs;
+    if (asleep) {
+        if (!scan->pressed) return false;
+        asleep = false;
+        waking = true;
+        Touch_ScanProfile(profile);
+    }
+    if (waking) {
+        if (scan->pressed) return false;
+        waking = false;
+    }
+    if (profile != TOUCH_PROFILE_PATTERN && activePad < 0
+            && nowMs - lastTouchMs >= TOUCH_IDLE_MS) {
+        asleep = true;
+        candidate = -1;
+        Touch_ScanProfile(TOUCH_PROFILE_WAKE);
+        return false;
+    }
+    return true;
+}
+
+static void ProcessScan(const TouchScan *scan) {
+    int8_t pad;
+    AdvanceClock(scan->tick);
+    if (!Awake(scan)) return;
+    if (activePad >= 0 && !(scan->pressed & (1 << activePad))) {
+        Emit(TOUCH_RELEASE, activePad);
+        activePad = -1;
+    }
+    pad = LeadingPad(scan);
+    if (pad < 0) {  // too close to call leaves the count as it is
+        if (!scan->pressed) candidate = -1;  // unless all pads are up
+    } else if (pad == activePad) candidate = -1;
+    else {
+        if (pad != candidate) { candidate = pad; candidateScans = 0; }
+        if (++candidateScans >= TOUCH_SETTLE_SCANS) {
+            if (activePad >= 0) Emit(TOUCH_RELEASE, activePad);  // slid over
+            activePad = pad;
+            candidate = -1;
+            holdSent = false;
+            nextTimeout = nowMs + TOUCH_HOLD_MS;
+            Emit(TOUCH_PRESS, pad);
+            return;
+        }
+    }
+    if (activePad >= 0) HoldRepeat();
+}
+
+// Waits for the next scan and turns it, and any others that piled up, into
+// events, so whoever calls it runs at the scan rate.
+void Touch_Update(void) {
+    TouchScan scan;
+    while (!Touch_ReadScan(&scan)) Idle();
+    do {
+#ifdef TOUCH_TRACE
+        Trace_Scan(&scan);
+#endif
+        ProcessScan(&scan);
+    } while (Touch_ReadScan(&scan));
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++)
+        buttons[i] = (scan.pressed >> i) & 1;
+}
+
+// Takes the oldest event, returns false if there is none. Never blocks.
+bool Touch_PollEvent(TouchEvent *ev) {
+    if (queueHead == queueTail) return false;
+    *ev = queue[queueTail & (TOUCH_QUEUE_SIZE - 1)];
+    queueTail++;
+    return true;
+}
+
+// the pad being touched, -1 if none
+int8_t Touch_ActivePad(void) {
+    return activePad;
+}
+
+// Sets the scan profile for what the application does now, which also
+// counts as activity
+void Touch_SetProfile(uint8_t p) {
+    profile = p;
+    lastTouchMs = nowMs;
+    asleep = false;
+    Touch_ScanProfile(p);
+}
+
+// REPEAT timing from the next HOLD on: the first comes firstMs after it,
+// each interval after that is speedupPct percent shorter than the one before
+// until it is down to fastestMs. fastestMs = firstMs repeats at a steady rate.
+void Touch_SetRepeat(uint16_t firstMs, uint16_t fastestMs, uint8_t speedupPct) {
+    repeatFirst = firstMs;
+    repeatFastest = fastestMs < firstMs ? fastestMs : firstMs;
+    repeatSpeedup = speedupPct;
+}
@@ -0,0 +1,40 @@
+/* Touch events for the user interface, built on the scans of TouchSense.c */
+#ifndef TOUCHINPUT__H
+#define	TOUCHINPUT__H
+
+#include "TouchSense.h"
+
+#ifndef TOUCH_SETTLE_SCANS
+#define TOUCH_SETTLE_SCANS  2     // scans a pad must lead to count as a press
+#endif
+#define TOUCH_HOLD_MS       500   // press to HOLD
+#define TOUCH_REPEAT_MS     150   // HOLD to the first REPEAT and between REPEATs
+#define TOUCH_REPEAT_FAST_MS 40   // fastest REPEATs when they speed up, for editing values
+#define TOUCH_REPEAT_SPEEDUP 12   // percent each REPEAT interval shortens by until then
+#define TOUCH_QUEUE_SIZE    8     // events buffered for the main loop, 2^n
+#ifndef TOUCH_CROSSTALK
+#define TOUCH_CROSSTALK     4     // share of center/ring signal seen by the other, /16
+#endif
+#ifndef TOUCH_MARGIN_PCT
+#define TOUCH_MARGIN_PCT    150   // lead over the next pad that decides, percent
+#endif
+#define TOUCH_IDLE_MS       20000 // untouched this long, scanning drops to the wake profile
+
+typedef enum { TOUCH_PRESS, TOUCH_RELEASE, TOUCH_HOLD, TOUCH_REPEAT } TouchEventType;
+
+typedef struct {
+    uint8_t type;   // TouchEventType
+    uint8_t pad;    // 0 up, 1 right, 2 down, 3 left, 4 center
+    uint32_t time;  // ms since start, from the scan that caused it
+} TouchEvent;
+
+extern uint8_t buttons[NUM_TOUCHPADS];  // debounced pad states of the last scan
+extern uint16_t touchEventsLost;        // events dropped because the queue was full
+
+void Touch_Update(void);
+bool Touch_PollEvent(TouchEvent *ev);
+int8_t Touch_ActivePad(void);
+void Touch_SetProfile(uint8_t profile);
+void Touch_SetRepeat(uint16_t firstMs, uint16_t fastestMs, uint8_t speedupPct);
+
+#endif	/* TOUCHINPUT__H */
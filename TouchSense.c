@@ -14,6 +14,7 @@
 #define CTMU_NO_EDGE_SEQUENCE           0x0000
 #define CTMU_CURRENT_NOT_GROUNDED       0x0000
 #define CTMU_TRIGGER_OUT_DISABLED       0x0000
+#define CTMU_TRIGGER_OUT_ENABLED        0x0100
 #define CTMU_EDGE2_NEGATIVE             0x0000
 #define CTMU_EDGE2_CTED1                0x0060
 #define CTMU_EDGE2_CTED2                0x0040
@@ -23,149 +24,408 @@
 #define CTMU_EDGE_MASK                  0x0003
 #define CTMU_EDGE2                      0x0002
 #define CTMU_EDGE1                      0x0001
+#define CTMU_EDGES_ENABLED              0x0800
+#define CTMU_EDGE2_POSITIVE             0x0080
+#define CTMU_EDGE2_OC1                  0x0020
+#define CTMU_EDGE1_OC1                  0x0004
 
-#define AVG_DELAY                       64 //1 
-#define CHARGE_TIME_COUNT               90 //34 // If optimized, change value
+// OC1 ends the charge windows, its rising edge is an edge of the CTMU (the red
+// LED runs on OC4 for it)
+#define OC_CLOCK_FCY                    0x1C00  // OC1CON1: counts Fcy
+#define OC_DUAL_SINGLE                  0x0004  //   high at OC1R, low and interrupt at OC1RS
+#define OC_SYNC_SELF                    0x001F  // OC1CON2: free running
 
-uint8_t buttons[NUM_TOUCHPADS];
-uint16_t _potADC;
+// the CTMU's trigger, raised by edge2, ends sampling and starts the conversion
+#define ADC_TRIGGER_CTMU                0x0080  // AD1CON1: SSRC
 
-// global variables used in reading and averaging touch pad's values
-uint16_t rawCTMU[NUM_TOUCHPADS];   // raw AD value
-uint16_t average[NUM_TOUCHPADS];   // averaged AD value
+#define CONVERT_TICKS                   48 // a conversion, 12 TAD of 3 Tcy, and margin
+
+volatile uint16_t touchOverruns;  // scans lost because the ring was full
+volatile uint16_t touchLate;      // timer ticks that found a scan still running
+volatile uint16_t scanTicks;      // Timer3 ticks, the time base of the scans
+
+// Baselines follow the untouched reading of each pad through an IIR filter,
+// fast upwards (a touch ends) and slow downwards (drift). The variance of the
+// readings around it is the noise floor the trip point is derived from.
+#define BASE_SHIFT      10   // drift tracking, about 1024 samples
+#define BASE_RISE_SHIFT 4    // readings above the baseline, about 16 samples
+#define WARMUP_SHIFT    2    // settling at power-up
+#define NOISE_SHIFT     6    // noise variance, about 64 samples
+
+#define WARMUP_SAMPLES   (32 * NUM_TOUCHPADS)  // calibration from scratch
+#define CHECK_SAMPLES    2                     // per pad, check of a stored calibration
+#define CAL_SETTLE_SCANS (TOUCH_SCAN_HZ * 10)  // untouched scans before it is worth storing
+#define RESUME_SAMPLES   4                     // catching up on drift after a pause
+
+// global variables used in reading and tracking touch pad's values
+uint16_t rawCTMU[NUM_TOUCHPADS];   // raw AD value, x16
+int16_t deltaCTMU[NUM_TOUCHPADS];  // drop below the baseline, x16
+uint32_t baseline[NUM_TOUCHPADS];  // untouched reading, x16 with 8 fraction bits
+int32_t noiseVar[NUM_TOUCHPADS];   // variance of the reading around baseline
 uint16_t trip   [NUM_TOUCHPADS];   // trip point for touch pad
 uint16_t hyst   [NUM_TOUCHPADS];   // hysteresis for touch pad
+uint16_t pressScans[NUM_TOUCHPADS]; // samples the pad has been pressed for
 uint8_t first;          // first variable to 'discard' first N samples
-uint8_t buttonInd;      // index of touch pad being checked
-uint16_t value, bigVal, smallAvg;  // button's value, bigval, smallavg
-uint16_t AvgIndex;
-
-// read potentiometer and store value in global variable
-void ReadPotentiometer() {
-    AD1CON1 = 0x00E4;   // Off, Auto sample start, auto-convert
-    AD1CON2 = 0;        // AVdd, AVss, int every conversion, MUXA only
-    AD1CON3 = 0x1F05;   // 31 Tad auto-sample, Tad = 5*Tcy
-    AD1CHS  = 0x0;      // MUXA uses AN0
-    AD1CSSL = 0;        // No scanned inputs
-    AD1CON1bits.ADON = 1;        // turn on ADC module
-    while(!AD1CON1bits.DONE);    // wait for conversion to complete
-    _potADC = ADC1BUF0;
-    AD1CON1bits.ADON = 0;        // turn off ADC module
-}
-
-// routine to set up CTMU for capacitive touch sensing
-void CTMUInit( void ) {
+bool calStored;         // the calibration in use is the one in flash
+uint16_t calAge;        // untouched scans since the calibration started
+
+// Scanner, runs in interrupt context: Timer3 starts a scan, every ADC
+// interrupt ends a batch of TOUCH_OVERSAMPLE conversions (SMPI) collected in
+// ADC1BUF0.. and starts the next. Per pad each conversion measures one
+// drain and charge cycle: OC1 ends the charge, which starts the conversion,
+// and interrupts once it is over to start the next cycle.
+enum { SCAN_IDLE, SCAN_PAD };
+volatile uint8_t scanStep = SCAN_IDLE;
+uint8_t scanPad;                       // pad being measured
+uint8_t scanPads;                      // pads of this scan, bit n = pad n
+uint8_t profileTicks;                  // ticks since the last scan started
+uint8_t padResume[NUM_TOUCHPADS];      // samples left to catch up after a pause
+
+// Scan profiles, see TouchProfile: which pads, every how many ticks
+static const struct { uint8_t pads; uint8_t ticks; } profiles[] = {
+    { 1 << 4, TOUCH_SCAN_HZ / 50 },    // wake: center only, 50 Hz
+    { 0x1F,   TOUCH_SCAN_HZ / 200 },   // menus: 200 Hz
+    { 0x1F,   1 },                     // pattern entry: every tick
+};
+volatile uint8_t scanProfile = TOUCH_PROFILE_PATTERN;
+uint16_t chargeTicks[NUM_TOUCHPADS];   // charge window per pad, ticks of Fcy
+uint8_t batchLeft;                     // charge cycles of the batch not converted yet
+uint8_t padState;                      // debounced states, bit n = pad n
+uint8_t padCount[NUM_TOUCHPADS];       // scans the raw state disagreed
+
+// Scans from the ISR to the main loop. Single producer (ISR) moves only
+// ringHead, single consumer (main) moves only ringTail, so neither side
+// needs to mask interrupts.
+TouchScan ring[TOUCH_RING_SIZE];
+volatile uint8_t ringHead, ringTail;
+
+// trip points until the noise is measured
+static void SetDefaults(void) {
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++ ) {
+        trip[i] = TRIP_VALUE; hyst[i] = HYSTERESIS_VALUE;
+        noiseVar[i] = (int32_t)(TRIP_VALUE / TOUCH_NOISE_SIGMAS) * (TRIP_VALUE / TOUCH_NOISE_SIGMAS);
+    }
+}
+
+// drains the pad on the selected channel while the ADC samples it
+static void Drain(void) {
+    AD1CON1bits.SAMP = 1;        // manually sample
+    // wait for ADC to begin sampling
+    Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop();
+    CTMUCONbits.IDISSEN = 1;  // drain any charge on circuit
+    Nop(); Nop(); Nop(); Nop(); Nop();
+    CTMUCONbits.IDISSEN = 0;
+    CTMUCONbits.EDG2STAT = 0;  // make sure edge2 is 0
+}
+
+// Charges for ticks of Fcy: edge1 starts the charge, the OC1R match sets
+// edge2, the current stops and the conversion starts, all in hardware. OC1
+// flags CONVERT_TICKS later, when the result is in. The same two writes start
+// every window, calibration and scanner alike, so the window does not change
+// with the build.
+static void StartWindow(uint16_t ticks) {
+    OC1CON1 = 0; OC1TMR = 0; OC1R = ticks; OC1RS = ticks + CONVERT_TICKS;
+    IFS0bits.OC1IF = 0;
+    CTMUCONbits.EDG1STAT = 1;   // set edge1 - start charge
+    OC1CON1 = OC_CLOCK_FCY | OC_DUAL_SINGLE;
+}
+
+// after the window: both edges back to 0 in one write, so the current stays off
+static void EndWindow(void) {
+    CTMUCON &= ~CTMU_EDGE_MASK;
+    OC1CON1 = 0;
+}
+
+// One drain, charge and convert cycle, polled, before the scanner runs
+static uint16_t MeasureCharge(uint8_t pad, uint16_t ticks) {
+    AD1CHS = STARTING_ADC_CHANNEL + pad; //select A/D channel
+    Drain();
+    StartWindow(ticks);
+    while (!IFS0bits.OC1IF);    // converted already, seeing it late changes nothing
+    EndWindow();
+    return ADC1BUF0;
+}
+
+// Charge window that brings the untouched pad to TOUCH_CHARGE_TARGET, the
+// middle of the ADC range with room for drift. The reading grows linearly
+// with the window, so one scaling step and one correction are enough.
+static uint16_t CalibrateCharge(uint8_t pad) {
+    uint32_t ticks = TOUCH_CHARGE_TICKS;
+    for (uint8_t i = 0; i < 2; i++) {
+        uint16_t v = MeasureCharge(pad, ticks);
+        ticks = ticks * TOUCH_CHARGE_TARGET / (v ? v : 1);
+        if (ticks < TOUCH_CHARGE_MIN) ticks = TOUCH_CHARGE_MIN;
+        if (ticks > TOUCH_CHARGE_MAX) ticks = TOUCH_CHARGE_MAX;
+    }
+    return ticks;
+}
+
+// A stored calibration still fits if every pad, charged for its stored
+// window, reads within half its trip point of its stored baseline
+static bool CalibrationFits(const TouchCal *cal) {
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        for (uint8_t n = 0; n < CHECK_SAMPLES; n++) {
+            uint16_t sum = 0;
+            for (uint8_t k = 0; k < TOUCH_OVERSAMPLE; k++) sum += MeasureCharge(i, cal->charge[i]);
+            int16_t delta = cal->baseline[i] - sum * (16 / TOUCH_OVERSAMPLE);
+            if (delta >= (int16_t)(cal->trip[i] / 2) || delta <= -(int16_t)(cal->trip[i] / 2))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Routine to set up CTMU for capacitive touch sensing and start the scanner.
+// With a stored calibration the pads start from it after a short check that
+// the readings still match, otherwise (or if they don't) they calibrate anew,
+// charge windows included.
+void CTMUInit(const TouchCal *cal) {
     TRISB    = 0x1F01;   //RB0, RB8, RB9, RB10, RB11, RB12 in tri-state
     AD1PCFGL &= ~0x1F01;
         CTMUCON = CTMU_OFF | CTMU_CONTINUE_IN_IDLE | CTMU_EDGE_DELAY_DISABLED |
-              CTMU_EDGES_BLOCKED | CTMU_NO_EDGE_SEQUENCE |
-              CTMU_CURRENT_NOT_GROUNDED | CTMU_TRIGGER_OUT_DISABLED |
-              CTMU_EDGE2_NEGATIVE | CTMU_EDGE2_CTED1 | CTMU_EDGE1_POSITIVE |
-              CTMU_EDGE1_CTED1;  // Set up the CTMU
+              CTMU_EDGES_ENABLED | CTMU_NO_EDGE_SEQUENCE |
+              CTMU_CURRENT_NOT_GROUNDED | CTMU_TRIGGER_OUT_ENABLED |
+              CTMU_EDGE2_POSITIVE | CTMU_EDGE2_OC1 | CTMU_EDGE1_POSITIVE |
+              CTMU_EDGE1_OC1;  // Set up the CTMU, OC1 ends the charge
+    OC1CON1 = 0; OC1CON2 = OC_SYNC_SELF;
     CTMUICONbits.IRNG = 2;   // 5.5uA
     CTMUICONbits.ITRIM = 0;  // 0%
-    // Set up the ADC:
-    AD1CON1            = 0x0000;
-    AD1CHS             = STARTING_ADC_CHANNEL; // set starting analog channel
+    // Set up the ADC: manual sampling, the end of the charge starts the conversion
+    AD1CON1            = ADC_TRIGGER_CTMU;
     AD1CSSL            = 0x0000;
     AD1CON1bits.FORM   = 0x0;                  // unsigned int format
     AD1CON3            = 0x0002;
-    AD1CON2            = 0x0000;
-    AD1CON1bits.ADON   = 1;           // ADC in continuous mode
+    AD1CON2            = 0x0000;               // every result in ADC1BUF0 for now
+    AD1CON1bits.ADON   = 1;
+    AD1CON1bits.SAMP   = 1;
     CTMUCONbits.CTMUEN = 1;           // enable CTMU
-    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++ ) {
-        trip[i] = TRIP_VALUE; hyst[i] = HYSTERESIS_VALUE;
+    if (cal && !CalibrationFits(cal)) cal = NULL;  // start from scratch
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++ )
+        chargeTicks[i] = cal ? cal->charge[i] : CalibrateCharge(i);
+    AD1CON1bits.ADON   = 0;
+    AD1CON2bits.SMPI   = TOUCH_OVERSAMPLE - 1; // interrupt once per batch
+    AD1CON1bits.ADON   = 1;
+    SetDefaults();
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++ ) baseline[i] = 0;
+    first = WARMUP_SAMPLES;  // detection starts here after averaging over enough values
+    calStored = (cal != NULL);
+    if (cal) {
+        for (uint8_t i = 0; i < NUM_TOUCHPADS; i++ ) {
+            baseline[i] = (uint32_t)cal->baseline[i] << 8;
+            noiseVar[i] = (int32_t)cal->noise[i] * cal->noise[i];
+            trip[i] = cal->trip[i];
+            hyst[i] = (uint32_t)trip[i] * HYSTERESIS_VALUE / TRIP_VALUE;
+        }
+        first = 0;  // checked already
+    }
+    calAge = 0;
+    scanPads = profiles[scanProfile].pads;
+    // Timer3 ticks the scans, the ADC interrupt runs them, both above the
+    // display flush. OC1 chains the cycles of a batch at the ADC's level, so
+    // neither can cut into the other: when the ADC has moved on to the next
+    // pad first, StartWindow() drops the last OC1 flag of the batch before.
+    // Windows and conversions are timed in hardware either way.
+    T3CON = 0x0010;                   // off, prescale 1:8
+    TMR3 = 0;
+    PR3 = TOUCH_TIMER_CLOCK / TOUCH_SCAN_HZ - 1;
+    IPC2bits.T3IP = 2;  IFS0bits.T3IF = 0;  IEC0bits.T3IE = 1;
+    IPC3bits.AD1IP = 3; IFS0bits.AD1IF = 0; IEC0bits.AD1IE = 1;
+    IPC0bits.OC1IP = 3; IFS0bits.OC1IF = 0; IEC0bits.OC1IE = 1;
+    T3CONbits.TON = 1;
+}
+
+static uint16_t ISqrt(uint32_t v) {
+    uint32_t r = 0, bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else r >>= 1;
+        bit >>= 2;
+    }
+    return r;
+}
+
+// trip point from the measured noise, hysteresis in the ratio of the defaults
+static void UpdateTrip(uint8_t pad) {
+    uint32_t t = (uint32_t)TOUCH_NOISE_SIGMAS * ISqrt(noiseVar[pad]);
+    if (t < TOUCH_TRIP_MIN) t = TOUCH_TRIP_MIN;
+    if (t > TOUCH_TRIP_MAX) t = TOUCH_TRIP_MAX;
+    trip[pad] = t;
+    hyst[pad] = t * HYSTERESIS_VALUE / TRIP_VALUE;
+}
+
+// Detection for one sample of a pad, the sum of TOUCH_OVERSAMPLE conversions:
+// measure against the baseline, decide pressed or not, then track drift and
+// noise while the pad is not touched. Returns the raw (undebounced) state.
+uint8_t Touch_ProcessSample(uint8_t pad, uint16_t value) {
+    uint16_t bigVal = value * (16 / TOUCH_OVERSAMPLE); // x16 for greater sensitivity
+    int32_t diff = ((int32_t)bigVal << 8) - (int32_t)baseline[pad];
+    int16_t delta = -(int16_t)(diff >> 8);  // drop below the baseline, x16
+    uint8_t pressed = (padState >> pad) & 1;
+    rawCTMU[pad] = bigVal;             // raw array = most recent bigVal
+    deltaCTMU[pad] = delta;
+    if (padResume[pad] > 0) {  // not scanned for a while: follow the drift first
+        padResume[pad]--;
+        baseline[pad] += diff >> WARMUP_SHIFT;
+        return 0;
     }
-    buttonInd = 0;
-    first = 160;  // detection starts here after averaging over enough values
+    if (first > 0) {  // on power-up, reach steady-state readings first
+        first--;
+        baseline[pad] += diff >> WARMUP_SHIFT;
+        return 0;
+    }
+    // is keypad pressed or released?
+    if (delta < (int16_t)(trip[pad] - hyst[pad])) {
+        pressed = 0;
+    } else if (delta > (int16_t)trip[pad]) {
+        pressed = 1;
+    }
+    if (pressed) {  // baseline and noise stand still while touched
+        if (++pressScans[pad] < TOUCH_MAX_PRESS_SCANS) return 1;
+        baseline[pad] = (uint32_t)bigVal << 8;  // stuck: take the reading as untouched
+        pressScans[pad] = 0;
+        return 0;
+    }
+    pressScans[pad] = 0;
+    // quick-release upwards, slow drift compensation downwards
+    baseline[pad] += diff >> (diff > 0 ? BASE_RISE_SHIFT : BASE_SHIFT);
+    // readings near the baseline are noise, a finger closing in is not
+    if (delta < (int16_t)(trip[pad] / 2) && delta > -(int16_t)(trip[pad] / 2)) {
+        noiseVar[pad] += ((int32_t)delta * delta - noiseVar[pad]) >> NOISE_SHIFT;
+        UpdateTrip(pad);
+    }
+    return pressed;
+}
+
+// a pad state only changes after TOUCH_DEBOUNCE_SCANS scans agree on it
+static void Debounce(uint8_t pad, uint8_t pressed) {
+    if (pressed == ((padState >> pad) & 1)) { padCount[pad] = 0; return; }
+    if (++padCount[pad] < TOUCH_DEBOUNCE_SCANS) return;
+    padCount[pad] = 0;
+    padState ^= 1 << pad;
+}
+
+// hands a finished scan to the main loop, or drops it if the ring is full
+static void Publish(void) {
+    TouchScan *s;
+    if ((uint8_t)(ringHead - ringTail) == TOUCH_RING_SIZE) { touchOverruns++; return; }
+    s = &ring[ringHead & (TOUCH_RING_SIZE - 1)];
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        s->raw[i] = rawCTMU[i];
+        s->delta[i] = deltaCTMU[i];
+    }
+    s->pressed = padState;
+    s->pads = scanPads;
+    s->tick = scanTicks;
+    ringHead++;
+    if (first == 0 && padState == 0 && calAge < CAL_SETTLE_SCANS) calAge++;
+}
+
+// sum of the conversions of the batch that just ended
+static uint16_t BatchSum(void) {
+    volatile uint16_t *buf = &ADC1BUF0;
+    uint16_t sum = 0;
+    for (uint8_t n = 0; n < TOUCH_OVERSAMPLE; n++) sum += buf[n];
+    return sum;
+}
+
+// drains the pad and charges it until OC1 ends the window
+static void StartCharge(void) {
+    Drain();
+    StartWindow(chargeTicks[scanPad]);
+}
+
+// Runs TOUCH_OVERSAMPLE charge and convert cycles on a pad, chained by the OC1
+// interrupt. The ADC interrupts once the last conversion is in its buffer.
+static void StartPadBatch(uint8_t pad) {
+    AD1CHS = STARTING_ADC_CHANNEL + pad; //select A/D channel
+    batchLeft = TOUCH_OVERSAMPLE;
+    StartCharge();
+}
+
+// first pad of this scan from pad on, NUM_TOUCHPADS if there is none
+static uint8_t NextPad(uint8_t pad) {
+    while (pad < NUM_TOUCHPADS && !(scanPads & (1 << pad))) pad++;
+    return pad;
+}
+
+// Takes on the profile at the start of a scan. Pads it drops read as
+// released; pads it adds catch up with their drift before they detect again.
+static void ApplyProfile(void) {
+    uint8_t pads = profiles[scanProfile].pads;
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        if (!(pads & (1 << i))) { deltaCTMU[i] = 0; padCount[i] = 0; }
+        else if (!(scanPads & (1 << i))) padResume[i] = RESUME_SAMPLES;
+    }
+    padState &= pads;
+    scanPads = pads;
 }
 
-// Capacitive touch sensing service routine for CTMU:  Measure, determine if 
-// button under test is pressed or not, set flag accordingly, then average.
-// The Starter Kit's potentiometer is also read here.
-void ReadCTMU() {
+void __attribute__((__interrupt__, no_auto_psv)) _T3Interrupt(void) {
+    IFS0bits.T3IF = 0;
+    scanTicks++;
+    if (++profileTicks < profiles[scanProfile].ticks) return;
+    if (scanStep != SCAN_IDLE) { touchLate++; return; }
+    profileTicks = 0;
+    if (scanPads != profiles[scanProfile].pads) ApplyProfile();
+    scanPad = NextPad(0);
+    scanStep = SCAN_PAD;
+    StartPadBatch(scanPad);
+}
+
+// a charge and its conversion are over, next cycle of the batch
+void __attribute__((__interrupt__, no_auto_psv)) _OC1Interrupt(void) {
+    EndWindow();
+    IFS0bits.OC1IF = 0;
+    if (--batchLeft) StartCharge();
+}
+
+void __attribute__((__interrupt__, no_auto_psv)) _ADC1Interrupt(void) {
+    IFS0bits.AD1IF = 0;
+    if (scanStep != SCAN_PAD) return;
+    Debounce(scanPad, Touch_ProcessSample(scanPad, BatchSum()));
+    scanPad = NextPad(scanPad + 1);
+    if (scanPad < NUM_TOUCHPADS) {  // move to next pad
+        StartPadBatch(scanPad);
+        return;
+    }
+    Publish();
+    scanStep = SCAN_IDLE;
+}
+
+// Takes the oldest scan not read yet, returns false if there is none. After
+// a long stall of the main loop (ring full) it skips to the newest scan.
+bool Touch_ReadScan(TouchScan *scan) {
+    uint8_t head = ringHead;
+    if (head == ringTail) return false;
+    if ((uint8_t)(head - ringTail) == TOUCH_RING_SIZE) ringTail = head - 1;
+    *scan = ring[ringTail & (TOUCH_RING_SIZE - 1)];
+    ringTail++;
+    return true;
+}
+
+// Copies what the pads have learned, to be stored in flash
+void Touch_GetCalibration(TouchCal *cal) {
     uint16_t current_ipl;
-    volatile unsigned int tempADch;
-    tempADch            = AD1CHS;  // store the current A/D mux channel selected
-    AD1CON1             = 0x0000;  // unsigned integer format
-    AD1CSSL             = 0x0000;
-    AD1CON3             = 0x0002;
-    AD1CON2             = 0x0000;
-    AD1CON1bits.ADON    = 1;            // Start A/D in continuous mode
-    for(uint8_t i=0; i<NUM_TOUCHPADS; i++) {
-        // Get the raw sensor reading:
-        AD1CHS = STARTING_ADC_CHANNEL + buttonInd; //select A/D channel
-        IFS0bits.AD1IF = 0;  // ensure touch circuit is discharged
-        AD1CON1bits.DONE = 0;
-        AD1CON1bits.SAMP = 1;        // manually sample
-        // wait for ADC to begin sampling
-        Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop();
-        CTMUCONbits.IDISSEN = 1;  // drain any charge on circuit
-        Nop(); Nop(); Nop(); Nop(); Nop();
-        CTMUCONbits.IDISSEN = 0;
-        Nop(); Nop(); Nop(); Nop(); Nop();
-        IFS0bits.AD1IF = 0;
-        AD1CON1bits.SAMP = 0;  // manually start conversion
-        while(!IFS0bits.AD1IF);  // ADC to drain CTMU charge
-
-        SET_AND_SAVE_CPU_IPL( current_ipl, 7 );  // turn off interrupts
-        IFS0bits.AD1IF = 0;
-        AD1CON1bits.SAMP = 1;      // manually start sampling
-        CTMUCONbits.EDG2STAT = 0;  // make sure edge2 is 0
-        CTMUCONbits.EDG1STAT = 1;   // set edge1 - start charge
-        for (uint8_t j=0; j<CHARGE_TIME_COUNT; j++); // CTMU charge time delay
-        CTMUCONbits.EDG1STAT = 0;  // Clear edge1 - Stop Charge
-        RESTORE_CPU_IPL( current_ipl );  // re-enable interrupts
-
-        IFS0bits.AD1IF = 0;
-        AD1CON1bits.SAMP = 0;
-        while(!IFS0bits.AD1IF);  // wait for ADC
-        value = ADC1BUF0;
-        
-        IFS0bits.AD1IF = 0;    // discharge touch circuit
-        AD1CON1bits.SAMP = 1;  // manually start sampling
-
-        // wait for A/D conversion to begin
-        Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop();
-        CTMUCONbits.IDISSEN = 1;        // drain any charge on circuit
-        Nop(); Nop(); Nop(); Nop(); Nop(); 
-        CTMUCONbits.IDISSEN = 0;        // end charge drain
-        Nop(); Nop(); Nop(); Nop();
-        IFS0bits.AD1IF = 0;
-        AD1CON1bits.SAMP = 0;    // perform conversion
-        while(!IFS0bits.AD1IF);  // wait for ADC
-        IFS0bits.AD1IF = 0;
-        AD1CON1bits.DONE = 0;  // ADC to drain CTMU charge
-        
-        bigVal = value  * 16; // *16 for greater sensitivity
-        
-        smallAvg = average[buttonInd]/16;  // smallAvg = average >> 4 bits
-        rawCTMU[buttonInd] = bigVal;       // raw array = most recent bigVal
-        if (first > 0) {  // on power-up, reach steady-state readings first
-            first--;
-            average[buttonInd] = bigVal;
-            if (++buttonInd == NUM_TOUCHPADS) buttonInd = 0;
-            break;
-        }
-        // is keypad pressed or released?
-        if (bigVal > (average[buttonInd]-trip[buttonInd]+hyst[buttonInd])) {
-            buttons[buttonInd] = 0;
-        } else if (bigVal < (average[buttonInd] - trip[buttonInd])) {
-            buttons[buttonInd] = 1;
-        }
-        // implement quick-release for released button
-        if (bigVal > average[buttonInd]) {  // if raw above average,
-            average[buttonInd] = bigVal;    // then reset to high average
-        }
-        // average in the new value:
-        if(buttonInd == 0) {
-            if (AvgIndex < AVG_DELAY) AvgIndex++; else AvgIndex = 0;
-        }
-        if (AvgIndex == AVG_DELAY) {  // average raw value
-            average[buttonInd] = average[buttonInd] + (value - smallAvg);
-        }
-        if (++buttonInd == NUM_TOUCHPADS) buttonInd = 0;  // move to next pad
+    SET_AND_SAVE_CPU_IPL( current_ipl, 3 );  // hold the scanner off
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        cal->baseline[i] = baseline[i] >> 8;
+        cal->trip[i] = trip[i];
+        cal->noise[i] = ISqrt(noiseVar[i]);
+        cal->charge[i] = chargeTicks[i];
     }
-    ReadPotentiometer();  // read potentiometer in _potADC
-    AD1CHS = tempADch;    // restore A/D channel select
-}
\ No newline at end of file
+    RESTORE_CPU_IPL( current_ipl );
+}
+
+// True once, when a calibration learned from scratch has settled and should
+// be stored. A stored calibration that passed the check is not written again.
+bool Touch_CalibrationDue(void) {
+    if (calStored || calAge < CAL_SETTLE_SCANS) return false;
+    calStored = true;
+    return true;
+}
+
+// Selects which pads are scanned how often, from the next scan on
+void Touch_ScanProfile(uint8_t profile) {
+    scanProfile = profile;
+}
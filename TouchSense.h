@@ -4,18 +4,79 @@
 #define	TOUCHSENSE__H
 
 #include <xc.h>
+#include "Clock.h"
+#include <stdbool.h>
+#include <stdint.h>
 
-#define TRIP_VALUE          0x500  // go to 1000 for more sensitive behaviors
-#define HYSTERESIS_VALUE    0x65
+// Detection settings can be overridden from the build, for a sweep with the
+// replay harness in host/
+#ifndef TRIP_VALUE
+#define TRIP_VALUE          0x500  // trip point until the pad's noise is measured
+#endif
+#ifndef HYSTERESIS_VALUE
+#define HYSTERESIS_VALUE    0x65   // at TRIP_VALUE, scales with the trip point
+#endif
+#ifndef TOUCH_NOISE_SIGMAS
+#define TOUCH_NOISE_SIGMAS  8      // trip point in noise standard deviations
+#endif
+#ifndef TOUCH_TRIP_MIN
+#define TOUCH_TRIP_MIN      0x180  // limits of the learned trip points, x16
+#endif
+#ifndef TOUCH_TRIP_MAX
+#define TOUCH_TRIP_MAX      0xA00
+#endif
+#define TOUCH_MAX_PRESS_SCANS (TOUCH_SCAN_HZ * 30)  // longer is a drift, not a finger
 
 #define NUM_TOUCHPADS 5
 #define STARTING_ADC_CHANNEL 8
 
-extern uint8_t buttons[NUM_TOUCHPADS];  // up, right, down, left, center
-extern uint16_t _potADC;
+// The pads are scanned from interrupts at a fixed rate (Timer3)
+#define TOUCH_SCAN_HZ        400   // Timer3 ticks per second, the fastest scan rate
+#ifndef TOUCH_DEBOUNCE_SCANS
+#define TOUCH_DEBOUNCE_SCANS 3     // scans a pad must agree on to change
+#endif
+#define TOUCH_RING_SIZE      16    // scans buffered for the main loop, 2^n
+#define TOUCH_TIMER_CLOCK    (FCY / 8)  // Timer3 prescale 1:8
+#ifndef TOUCH_OVERSAMPLE
+#define TOUCH_OVERSAMPLE     4     // conversions summed per pad reading, 2^n <= 16
+#endif
 
-void ReadPotentiometer();
-void CTMUInit();
-void ReadCTMU();
+// Charge window of the pads, OC1 ticks of Fcy (62.5 ns)
+#define TOUCH_CHARGE_TICKS   600   // start of the calibration
+#define TOUCH_CHARGE_MIN     64
+#define TOUCH_CHARGE_MAX     4000
+#ifndef TOUCH_CHARGE_TARGET
+#define TOUCH_CHARGE_TARGET  700   // untouched reading to calibrate to, of 1023
+#endif
+
+// Scan profiles, from light to full: the center pad alone at 50 Hz to wake
+// up, all pads at 200 Hz for menus, all pads every tick for pattern entry
+typedef enum { TOUCH_PROFILE_WAKE, TOUCH_PROFILE_MENU, TOUCH_PROFILE_PATTERN } TouchProfile;
+
+// One scan as published by the scanner
+typedef struct {
+    uint16_t raw[NUM_TOUCHPADS];  // latest reading of each pad, x16
+    int16_t delta[NUM_TOUCHPADS]; // baseline minus reading, x16
+    uint8_t pressed;              // debounced states, bit n = pad n
+    uint8_t pads;                 // pads this scan read, bit n = pad n
+    uint16_t tick;                // Timer3 tick the scan started on
+} TouchScan;
+
+// What the pads learned, kept in flash to start from at the next boot
+typedef struct {
+    uint16_t baseline[NUM_TOUCHPADS];  // untouched readings, x16
+    uint16_t trip[NUM_TOUCHPADS];      // trip points, x16
+    uint16_t noise[NUM_TOUCHPADS];     // noise standard deviations, x16
+    uint16_t charge[NUM_TOUCHPADS];    // charge windows, ticks of Fcy
+} TouchCal;
+
+extern volatile uint16_t touchOverruns, touchLate;
+
+void CTMUInit(const TouchCal *cal);
+void Touch_GetCalibration(TouchCal *cal);
+bool Touch_CalibrationDue(void);
+void Touch_ScanProfile(uint8_t profile);
+bool Touch_ReadScan(TouchScan *scan);
+uint8_t Touch_ProcessSample(uint8_t pad, uint16_t value);
 
 #endif	/* TOUCHSENSE__H */
@@ -0,0 +1,94 @@
+/* Raw pad trace, see TouchTrace.h. The encoders are always there, for the
+ * host tools; builds with TOUCH_TRACE defined also stream every scan the
+ * input layer takes on UART1. */
+#include "TouchTrace.h"
+
+uint16_t traceDropped;
+
+// appends the check byte, returns the length of the record
+static uint8_t Finish(uint8_t *out, uint8_t n) {
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < n; i++) sum += out[i];
+    out[n] = -sum;
+    return n + 1;
+}
+
+uint8_t Trace_EncodeHeader(uint8_t *out, const uint16_t *charge) {
+    uint8_t n = 0;
+    out[n++] = TRACE_HEADER;
+    out[n++] = 'T';
+    out[n++] = TRACE_VERSION;
+    out[n++] = NUM_TOUCHPADS;
+    out[n++] = TOUCH_SCAN_HZ & 0xFF;
+    out[n++] = TOUCH_SCAN_HZ >> 8;
+    out[n++] = TOUCH_OVERSAMPLE;
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        out[n++] = charge[i] & 0xFF;
+        out[n++] = charge[i] >> 8;
+    }
+    return Finish(out, n);
+}
+
+uint8_t Trace_EncodeScan(uint8_t *out, const TouchScan *scan) {
+    uint8_t n = 0;
+    out[n++] = TRACE_SCAN;
+    out[n++] = scan->tick & 0xFF;
+    out[n++] = scan->tick >> 8;
+    out[n++] = scan->pads;
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        if (!(scan->pads & (1 << i))) continue;
+        uint16_t sum = scan->raw[i] / (16 / TOUCH_OVERSAMPLE);
+        out[n++] = sum & 0xFF;
+        out[n++] = sum >> 8;
+    }
+    return Finish(out, n);
+}
+
+#ifdef TOUCH_TRACE
+// Send buffer, 256 bytes so the 8 bit indices wrap with it. The main loop
+// moves only txHead, the UART interrupt only txTail. tx is volatile too so
+// a record's bytes are stored before the txHead that hands them over.
+volatile uint8_t tx[256];
+volatile uint8_t txHead, txTail;
+uint16_t scansToHeader;
+bool traceStarted;
+
+// UART1 at TRACE_BAUD, 8N1, transmit only
+static void Start(void) {
+    TRACE_MAP_TX();
+    U1BRG = FCY / 4 / TRACE_BAUD - 1;  // BRGH
+    U1MODE = 0x0008;
+    U1MODEbits.UARTEN = 1;
+    U1STAbits.UTXEN = 1;
+    IPC3bits.U1TXIP = 1; IFS0bits.U1TXIF = 0;  // with the display, below touch
+    traceStarted = true;
+}
+
+// queues a whole record or drops it, never blocks
+static void Send(const uint8_t *rec, uint8_t n) {
+    if (n > 255 - (uint8_t)(txHead - txTail)) { traceDropped++; return; }
+    for (uint8_t i = 0; i < n; i++) tx[(uint8_t)(txHead + i)] = rec[i];
+    txHead += n;
+    IEC0bits.U1TXIE = 1;
+}
+
+// streams a scan, preceded by a header when one is due
+void Trace_Scan(const TouchScan *scan) {
+    uint8_t rec[TRACE_MAX_RECORD];
+    if (!traceStarted) Start();
+    if (scansToHeader == 0) {
+        TouchCal cal;
+        Touch_GetCalibration(&cal);
+        Send(rec, Trace_EncodeHeader(rec, cal.charge));
+        scansToHeader = TRACE_HEADER_SCANS;
+    }
+    scansToHeader--;
+    Send(rec, Trace_EncodeScan(rec, scan));
+}
+
+void __attribute__((__interrupt__, no_auto_psv)) _U1TXInterrupt(void) {
+    IFS0bits.U1TXIF = 0;
+    while (txTail != txHead && !U1STAbits.UTXBF) U1TXREG = tx[txTail++];
+    if (txTail == txHead) IEC0bits.U1TXIE = 0;
+}
+#endif
@@ -0,0 +1,33 @@
+/* Trace of the raw pad readings, to replay them through the detection code
+ * on a host (host/touchreplay). A little endian byte stream of records:
+ *   header  5A 'T' version pads hz(2) oversample charge(2 per pad) check
+ *   scan    A5 tick(2) pads sum(2 per pad read) check
+ * hz is the Timer3 tick rate, charge the charge windows in ticks of Fcy, tick
+ * the Timer3 tick of the scan, pads its bit mask of the pads read and sum
+ * what Touch_ProcessSample() got for each of them. check makes the bytes of
+ * a record add up to 0. A header goes out before the first scan and every
+ * TRACE_HEADER_SCANS scans after it, so a logger can join at any time. */
+#ifndef TOUCHTRACE__H
+#define	TOUCHTRACE__H
+
+#include "TouchSense.h"
+
+#define TRACE_HEADER        0x5A
+#define TRACE_SCAN          0xA5
+#define TRACE_VERSION       1
+#define TRACE_MAX_RECORD    (8 + 2 * NUM_TOUCHPADS)
+#define TRACE_HEADER_SCANS  400
+#define TRACE_BAUD          115200UL  // 15 bytes a scan, 6 kB/s at the full rate
+
+// U1TX goes to this remappable pin (output function 3), wire the logger there
+#ifndef TRACE_MAP_TX
+#define TRACE_MAP_TX()      (RPOR8bits.RP16R = 3)
+#endif
+
+extern uint16_t traceDropped;  // records that did not fit the send buffer
+
+uint8_t Trace_EncodeHeader(uint8_t *out, const uint16_t *charge);
+uint8_t Trace_EncodeScan(uint8_t *out, const TouchScan *scan);
+void Trace_Scan(const TouchScan *scan);
+
+#endif	/* TOUCHTRACE__H */
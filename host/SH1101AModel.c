@@ -0,0 +1,108 @@
+/* Software model of the PMP and the SH1101A controller, see SH1101AModel.h */
+#include <string.h>
+#include "SH1101AModel.h"
+
+// the registers of host/xc.h
+volatile uint16_t PMMODE, PMAEN, PMCON;
+volatile PMMODEBITS PMMODEbits;
+volatile PMCONBITS PMCONbits;
+volatile TRISDBITS TRISDbits;
+volatile LATDBITS LATDbits;
+volatile TRISBBITS TRISBbits;
+volatile LATBBITS LATBbits;
+volatile IEC2BITS IEC2bits;
+volatile IFS2BITS IFS2bits;
+volatile IPC11BITS IPC11bits;
+
+void _PMPInterrupt(void);
+
+ModelStats modelStats;
+uint8_t modelRam[DISP_PAGES][DISP_COLUMNS];
+uint8_t modelStartLine;
+
+static uint8_t page, column;
+static uint8_t argPending;    // the next command byte is an argument
+static uint8_t addressed;     // page or column set since the last RAM access
+static uint8_t dummyPending;  // the next read is the dummy read after an address set
+static uint8_t readLatch;     // PMP latch, returned by the next read of PMDIN1
+
+void Model_Reset(void) {
+    memset(&modelStats, 0, sizeof modelStats);
+    memset(modelRam, 0xA5, sizeof modelRam);  // undefined after power-on
+    modelStartLine = page = column = 0;
+    argPending = addressed = dummyPending = 0;
+}
+
+// SH1101A commands that take one argument byte
+static uint8_t HasArgument(uint8_t cmd) {
+    switch (cmd) {
+        case 0x81: case 0xA8: case 0xAD: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+    }
+    return 0;
+}
+
+static void Command(uint8_t cmd) {
+    modelStats.cmdBytes++;
+    if (argPending) { argPending = 0; return; }
+    if ((cmd & 0xF8) == 0xB0) page = cmd & 0x07;
+    else if (cmd < 0x10) column = (column & 0xF0) | cmd;
+    else if (cmd < 0x20) column = (column & 0x0F) | ((cmd & 0x0F) << 4);
+    else {
+        if ((cmd & 0xC0) == 0x40) modelStartLine = cmd & 0x3F;
+        else argPending = HasArgument(cmd);
+        return;
+    }
+    addressed = dummyPending = 1;
+}
+
+// a RAM access after new address commands completes one address setup
+static void Access(void) {
+    if (addressed) modelStats.addrSetups++;
+    addressed = 0;
+}
+
+void Model_Write(uint8_t data) {
+    modelStats.cycles++;
+    if (LATDbits.LATD11) { modelStats.unselected++; return; }
+    if (!LATBbits.LATB15) { Command(data); return; }
+    modelStats.dataWrites++;
+    Access();
+    if (page < DISP_PAGES && column < DISP_COLUMNS)
+        modelRam[page][column++] = data;
+}
+
+// Reading PMDIN1 returns the byte latched by the previous read cycle and
+// starts the next one, unless the PMP is disabled (see DeviceRead()).
+uint8_t Model_Read(void) {
+    uint8_t value = readLatch;
+    if (!PMCONbits.PMPEN) return value;
+    modelStats.cycles++;
+    if (LATDbits.LATD11) { modelStats.unselected++; return value; }
+    Access();
+    if (dummyPending) {
+        modelStats.dummyReads++;
+        dummyPending = 0;
+        readLatch = 0xFF;
+    } else {
+        modelStats.dataReads++;
+        readLatch = (column < DISP_COLUMNS) ? modelRam[page][column++] : 0xFF;
+    }
+    return value;
+}
+
+void Model_RunFlush(void) {
+    while (_flushBusy) _PMPInterrupt();
+}
+
+uint8_t Model_Pixel(int x, int y) {
+    uint8_t row = (y + modelStartLine) & (DISP_VER_RESOLUTION - 1);
+    return (modelRam[row >> 3][x + OFFSET] >> (row & 7)) & 1;
+}
+
+// one cycle is the data setup, strobe and hold phase, each WAITx + 1 periods
+// of the clock DriverInterfaceInit() bases its wait states on
+uint32_t Model_CycleNs(void) {
+    uint32_t pClockPeriod = (1000000000ul) / CLOCK_FREQ;
+    return (PMMODEbits.WAITB + 1 + PMMODEbits.WAITM + 1 + PMMODEbits.WAITE + 1) * pClockPeriod;
+}
@@ -0,0 +1,29 @@
+/* Software model of the PMP and the SH1101A controller for host builds of
+ * the display driver. It keeps the controller RAM, address pointers and
+ * start line, and counts every bus transaction. */
+#ifndef SH1101AMODEL_H
+#define SH1101AMODEL_H
+
+#include <stdint.h>
+#include "SH1101A.h"
+
+typedef struct {
+    uint32_t cycles;      // PMP bus cycles, reads and writes
+    uint32_t cmdBytes;    // bytes written with A0 low, commands and arguments
+    uint32_t dataWrites;  // bytes written into display RAM
+    uint32_t dataReads;   // display RAM bytes read
+    uint32_t dummyReads;  // reads the controller requires after an address set
+    uint32_t addrSetups;  // page/column address command sequences
+    uint32_t unselected;  // cycles with chip select inactive, a driver bug
+} ModelStats;
+
+extern ModelStats modelStats;
+extern uint8_t modelRam[DISP_PAGES][DISP_COLUMNS];
+extern uint8_t modelStartLine;
+
+void Model_Reset(void);        // power-on state, RAM filled with garbage
+void Model_RunFlush(void);     // services the PMP interrupt until the job ends
+uint8_t Model_Pixel(int x, int y);  // pixel shown at screen position x, y
+uint32_t Model_CycleNs(void);  // bus time of one cycle with the PMMODE waits
+
+#endif
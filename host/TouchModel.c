@@ -0,0 +1,66 @@
+/* Model of the touch scanner's peripherals, see TouchModel.h */
+#include "TouchModel.h"
+
+// the registers of host/xc.h
+volatile uint16_t TRISB, AD1PCFGL, CTMUCON, AD1CON1, AD1CON2, AD1CON3, AD1CHS, AD1CSSL;
+volatile uint16_t T3CON, TMR3, PR3;
+volatile uint16_t OC1CON1, OC1CON2, OC1TMR, OC1R, OC1RS;
+volatile AD1CON2BITS AD1CON2bits;
+volatile CTMUCONBITS CTMUCONbits;
+volatile CTMUICONBITS CTMUICONbits;
+volatile TCONBITS T3CONbits;
+volatile IEC0BITS IEC0bits;
+volatile IPC0BITS IPC0bits;
+volatile IPC2BITS IPC2bits;
+volatile IPC3BITS IPC3bits;
+
+extern volatile uint8_t scanStep;  // SCAN_IDLE (0) between scans
+void _T3Interrupt(void);
+void _OC1Interrupt(void);
+void _ADC1Interrupt(void);
+
+uint16_t modelSample[NUM_TOUCHPADS];
+uint16_t modelWindow[NUM_TOUCHPADS];
+uint32_t modelTicks;
+void (*modelFeed)(uint32_t tick);
+
+static volatile AD1CON1BITS ad1con1;
+static volatile IFS0BITS ifs0;
+static volatile uint16_t adcBuffer[16];
+
+volatile AD1CON1BITS *Model_AD1CON1(void) {
+    ad1con1.DONE = 1;
+    return &ad1con1;
+}
+
+volatile IFS0BITS *Model_IFS0(void) {
+    if (OC1CON1) ifs0.OC1IF = 1;
+    return &ifs0;
+}
+
+// The conversions of the selected channel, after a charge window of OC1R;
+// the reading grows linearly with it. The sum is spread over the batch's
+// buffers.
+volatile uint16_t *Model_ADCBuffer(void) {
+    uint32_t sum = 0;
+    uint8_t pad = AD1CHS - STARTING_ADC_CHANNEL;
+    if (AD1CHS >= STARTING_ADC_CHANNEL && pad < NUM_TOUCHPADS) {
+        sum = (uint32_t)modelSample[pad] * OC1R / modelWindow[pad];
+    }
+    for (uint8_t n = 0; n < TOUCH_OVERSAMPLE; n++) {
+        uint32_t v = sum / TOUCH_OVERSAMPLE + (n < sum % TOUCH_OVERSAMPLE);
+        adcBuffer[n] = v > 1023 ? 1023 : v;
+    }
+    return adcBuffer;
+}
+
+// one Timer3 tick and the scan it starts, if any, run to its end
+void TouchModel_Tick(void) {
+    if (modelFeed) modelFeed(modelTicks);
+    modelTicks++;
+    _T3Interrupt();
+    while (scanStep != 0) {
+        while (OC1CON1) _OC1Interrupt();
+        _ADC1Interrupt();
+    }
+}
@@ -0,0 +1,18 @@
+/* Model of the CTMU, the ADC and the timers for host builds of the touch
+ * scanner. Every Timer3 tick runs the scanner's interrupts to the end of the
+ * scan; a pad converts to the reading the harness set for it, scaled from
+ * the charge window it was taken with to the one the scanner uses. */
+#ifndef TOUCHMODEL_H
+#define TOUCHMODEL_H
+
+#include <stdint.h>
+#include "TouchSense.h"
+
+extern uint16_t modelSample[NUM_TOUCHPADS];  // pad readings, sums of TOUCH_OVERSAMPLE conversions
+extern uint16_t modelWindow[NUM_TOUCHPADS];  // charge windows they were taken with
+extern uint32_t modelTicks;                  // Timer3 ticks run
+extern void (*modelFeed)(uint32_t tick);     // sets the readings before each tick
+
+void TouchModel_Tick(void);
+
+#endif
@@ -0,0 +1,145 @@
+/* Rendering benchmark: draws the graphics primitives and the real screens
+ * through the display driver into the controller model and prints the bus
+ * transactions each one costs. Every flush is checked against the shadow
+ * framebuffer, the exit code is the number of mismatching steps. */
+#include <stdio.h>
+#include "SH1101AModel.h"
+#include "Graphics.h"
+#include "languages.h"
+#include "screens.h"
+#include "icons.h"
+
+// node positions and menu layout as in main.c
+static const uint8_t btnX[5] = {64, 104, 64, 24, 64};
+static const uint8_t btnY[5] = {12, 32, 52, 32, 32};
+static const uint8_t menuItemsAdmin[] = { S_M_CHANGE_PASS, S_M_CREATE_USER, S_M_ADVANCED, S_M_LANG, S_M_EXIT };
+
+static int failures;
+
+// Sends what was drawn since the last call, prints its cost and checks that
+// the controller now shows the shadow framebuffer.
+static void Measure(const char *name) {
+    ModelStats s = modelStats;
+    int bad = 0;
+    FlushDevice();
+    Model_RunFlush();
+    s.cycles = modelStats.cycles - s.cycles;
+    s.cmdBytes = modelStats.cmdBytes - s.cmdBytes;
+    s.dataWrites = modelStats.dataWrites - s.dataWrites;
+    s.dummyReads = modelStats.dummyReads - s.dummyReads;
+    s.dataReads = modelStats.dataReads - s.dataReads;
+    s.addrSetups = modelStats.addrSetups - s.addrSetups;
+    printf("%-30s %6u %6u %6u %6u %6u %6u %9.1f\n", name, s.cycles, s.cmdBytes,
+           s.dataWrites, s.dummyReads, s.dataReads, s.addrSetups,
+           s.cycles * Model_CycleNs() / 1000.0);
+    for (int y = 0; y < DISP_VER_RESOLUTION; y++)
+        for (int x = 0; x < DISP_HOR_RESOLUTION; x++)
+            if (Model_Pixel(x, y) != (GetPixel(x, y) ? 1 : 0)) bad = 1;
+    if (bad || modelStats.unselected) {
+        printf("  ^ display does not match the framebuffer\n");
+        failures++;
+    }
+}
+
+// black screen, already on the display
+static void Blank(void) {
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    FlushDevice(); Model_RunFlush();
+}
+
+static void Header(const char *title) {
+    printf("\n%-30s %6s %6s %6s %6s %6s %6s %9s\n", title, "cycles", "cmd",
+           "data", "dummy", "reads", "setups", "bus us");
+}
+
+static void Primitives(void) {
+    Header("primitive (on a blank screen)");
+    Blank(); PutPixel(64, 32); Measure("PutPixel");
+    Blank(); GFX_DrawLine(0, 31, 127, 31); Measure("GFX_DrawLine horizontal");
+    Blank(); GFX_DrawLine(64, 0, 64, 63); Measure("GFX_DrawLine vertical");
+    Blank(); GFX_DrawLine(0, 0, 127, 63); Measure("GFX_DrawLine shallow");
+    Blank(); GFX_DrawLine(40, 0, 60, 63); Measure("GFX_DrawLine steep");
+    Blank(); GFX_DrawNode(64, 32, false); Measure("GFX_DrawNode hollow");
+    Blank(); GFX_DrawNode(64, 32, true); Measure("GFX_DrawNode filled");
+    Blank(); UI_DrawChar(10, 10, 'A'); Measure("UI_DrawChar");
+    Blank(); UI_DrawString(0, 10, "The quick brown fox j"); Measure("UI_DrawString 21 chars");
+    Blank(); UI_DrawString(0, 12, "The quick brown fox j"); Measure("UI_DrawString unaligned");
+    Blank(); UI_PrintNum(10, 10, 42, true); Measure("UI_PrintNum");
+    Blank(); FillRect(48, 16, 79, 47); Measure("FillRect 32x32");
+    Blank(); InvertRect(2, 11, 7, 19); Measure("InvertRect cursor cell");
+    Blank(); DrawImage(56, 40, IMG_LOCK); Measure("DrawImage 16x16 icon");
+    Blank(); DrawImage(0, 0, IMG_LOGO); Measure("DrawImage full screen");
+    SetColor(BLACK); ClearDevice(); Measure("ClearDevice after full screen");
+    Blank(); ScrollDevice(8); Measure("ScrollDevice");
+    ScrollDevice(-8); FlushDevice(); Model_RunFlush();
+}
+
+static void AdminMenu(uint8_t cursor) {
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(35, 2, (char*)GetStr(S_MENU_ADMIN));
+    GFX_DrawLine(0, 9, 127, 9);
+    for (int i = 0; i < 5; i++) UI_DrawString(10, 12 + i * 9, (char*)GetStr(menuItemsAdmin[i]));
+    InvertRect(2, 11 + cursor * 9, 7, 19 + cursor * 9);
+}
+
+static void SetDate(int y, int m, int d, int cursor) {
+    int cursX = (cursor == 0) ? 22 : (cursor == 1) ? 48 : 74;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(10, 10, (char*)GetStr(S_SET_DATE));
+    UI_DrawString(10, 30, "20"); UI_PrintNum(22, 30, y, true);
+    UI_DrawString(38, 30, "/"); UI_PrintNum(48, 30, m, true);
+    UI_DrawString(64, 30, "/"); UI_PrintNum(74, 30, d, true);
+    GFX_DrawLine(cursX, 39, cursX + 10, 39);
+}
+
+static void UserConfig(void) {
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(30, 2, (char*)GetStr(S_CONF_TITLE));
+    UI_DrawString(10, 12, (char*)GetStr(S_LBL_ACTIVE)); UI_DrawString(50, 12, "[x]");
+    UI_DrawString(10, 22, (char*)GetStr(S_LBL_CHG_PW)); UI_DrawString(50, 22, "[ ]");
+    UI_DrawString(10, 32, (char*)GetStr(S_ACC_TYPE)); UI_DrawString(50, 32, (char*)GetStr(S_ACC_MULTI));
+    UI_DrawString(10, 42, (char*)GetStr(S_LBL_COUNT)); UI_PrintNum(50, 42, 5, false);
+    UI_DrawString(10, 55, (char*)GetStr(S_SAVE));
+}
+
+// the screens in the order a first start walks through them
+static void Screens(void) {
+    static const uint8_t pattern[3] = {3, 4, 1};
+    Header("screen (after the one above)");
+    Blank();
+    DrawImage(0, 0, GetScreen(SCR_WELCOME)); Measure("welcome");
+    SetDate(25, 1, 1, 0); Measure("set date");
+    SetDate(25, 1, 2, 0); Measure("set date, day + 1");
+    SetDate(25, 1, 2, 1); Measure("set date, cursor right");
+    DrawImage(0, 0, GetScreen(SCR_TUTORIAL)); Measure("tutorial");
+    DrawImage(0, 0, GetScreen(SCR_GRID)); Measure("pattern grid");
+    for (int i = 0; i < 3; i++) {
+        uint8_t n = pattern[i];
+        GFX_DrawNode(btnX[n], btnY[n], true);
+        if (i > 0) GFX_DrawLine(btnX[pattern[i - 1]], btnY[pattern[i - 1]], btnX[n], btnY[n]);
+        Measure(i == 0 ? "pattern, first node" : "pattern, next node");
+    }
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(20, 25, (char*)GetStr(S_PASS_SAVED)); Measure("pattern saved");
+    AdminMenu(0); Measure("admin menu");
+    AdminMenu(0); Measure("admin menu, same again");
+    InvertRect(2, 11, 7, 19);
+    InvertRect(2, 20, 7, 28); Measure("admin menu, cursor down");
+    UserConfig(); Measure("user config");
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(25, 25, (char*)GetStr(S_DOOR_UNLOCKED));
+    DrawImage(56, 40, IMG_UNLOCK); Measure("door unlocked");
+    DrawImage(0, 0, GetScreen(SCR_ERROR_MSG)); Measure("user limit message");
+}
+
+int main(void) {
+    Model_Reset();
+    ResetDevice();
+    printf("PMP cycle %u ns (WAITB %u, WAITM %u, WAITE %u)\n", Model_CycleNs(),
+           PMMODEbits.WAITB, PMMODEbits.WAITM, PMMODEbits.WAITE);
+    Header("display init");
+    Measure("ResetDevice + first flush");
+    Primitives();
+    Screens();
+    return failures;
+}
@@ -0,0 +1,392 @@
+/* Replay harness of the touch detection: feeds pad readings through the
+ * unmodified TouchSense.c and TouchInput.c, run on the peripheral model of
+ * TouchModel.c, and compares the PRESS events with where the fingers were.
+ *
+ *   touchreplay [-l label] [-q] [-s scenario [-w name]]
+ *       runs the synthetic scenarios (or one of them); -w also writes it as
+ *       name.trc and its touches as name.lbl
+ *   touchreplay [-l label] [-q] trace [labels]
+ *       replays a trace recorded with TOUCH_TRACE (see TouchTrace.h); the
+ *       labels file has a line "start_ms end_ms pad" per touch, without one
+ *       the presses are listed
+ *
+ * A touch is detected by a PRESS of its pad between its start and
+ * MATCH_LATE_MS after its end, the latency is the time to that PRESS. Other
+ * PRESSes are false touches. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "TouchModel.h"
+#include "TouchInput.h"
+#include "TouchTrace.h"
+
+#define MS(t)         ((uint32_t)(t) * TOUCH_SCAN_HZ / 1000)  // ms to ticks
+#define MAX_CONTACTS  64
+#define MAX_PRESSES   256
+#define MATCH_LATE_MS 50
+#define START_MS      1000  // first touch, after calibration
+#define RAMP_MS       10    // a finger lands and lifts this fast
+
+typedef struct {
+    uint32_t start, end;  // ticks
+    uint8_t pad;
+} Contact;
+
+typedef struct {
+    const char *name;
+    uint16_t signal;     // drop of a full touch, counts per conversion
+    uint8_t noise;       // standard deviation, counts per conversion
+    int16_t drift;       // untouched readings over the run, counts per conversion
+    uint8_t crosstalk;   // percent of the signal seen by the pad next to it
+    uint8_t spikes;      // scans in 1000 starting a spike of 1 or 2 scans on a pad
+    uint8_t swipe;       // touches slide across paths instead of tapping
+    uint16_t dwell;      // ms on a pad
+    uint16_t gap;        // ms between taps, overlap of the pads of a swipe
+    uint8_t count;       // taps or swipes
+} Scenario;
+
+static const Scenario scenarios[] = {
+    // name          signal noise drift  xt spk swp dwell gap count
+    { "taps",          120,   3,    0,   0,  0,  0, 150, 300, 20 },
+    { "light",          40,   3,    0,   0,  0,  0, 150, 300, 20 },
+    { "noisy",         120,  12,    0,   0,  0,  0, 150, 300, 20 },
+    { "drift",         120,   3, -150,   0,  0,  0, 150, 900, 24 },
+    { "spikes",          0,   3,    0,   0, 20,  0,   0,   0,  0 },
+    { "swipes",        120,   3,    0,  25,  0,  1, 120,  40,  6 },
+    { "fast-swipes",   120,   3,    0,  25,  0,  1,  60,  25,  6 },
+};
+#define NUM_SCENARIOS (sizeof scenarios / sizeof scenarios[0])
+
+// pads of the swipes: 0 up, 1 right, 2 down, 3 left, 4 center
+static const uint8_t paths[][6] = {
+    { 3, 4, 1, 0xFF }, { 0, 4, 2, 0xFF }, { 0, 1, 2, 0xFF },
+    { 3, 0, 1, 4, 2, 0xFF }, { 2, 4, 0, 0xFF }, { 1, 2, 3, 0, 0xFF },
+};
+
+static Contact contacts[MAX_CONTACTS];
+static uint8_t numContacts;
+static uint32_t runTicks;
+static const Scenario *scenario;
+
+static uint32_t presses[MAX_PRESSES];  // tick << 3 | pad
+static uint16_t numPresses;
+
+static FILE *traceOut;
+
+// recorded trace, one entry per scan record
+typedef struct {
+    uint32_t tick;
+    uint8_t pads;
+    uint16_t sum[NUM_TOUCHPADS];
+} Record;
+static Record *records;
+static uint32_t numRecords, nextRecord;
+
+static uint32_t rng = 0x2545F491;
+
+static uint32_t Random(void) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+// close to a standard normal distribution (Irwin-Hall)
+static double Gauss(void) {
+    double s = 0;
+    for (int i = 0; i < 12; i++) s += (Random() & 0xFFFF) / 65536.0;
+    return s - 6;
+}
+
+static void AddContact(uint8_t pad, uint32_t startMs, uint32_t endMs) {
+    if (numContacts == MAX_CONTACTS) return;
+    contacts[numContacts].pad = pad;
+    contacts[numContacts].start = MS(startMs);
+    contacts[numContacts].end = MS(endMs);
+    numContacts++;
+}
+
+static void Build(const Scenario *s) {
+    uint32_t t = START_MS;
+    numContacts = 0;
+    for (uint8_t i = 0; i < s->count; i++) {
+        if (!s->swipe) {
+            AddContact(i % NUM_TOUCHPADS, t, t + s->dwell);
+            t += s->dwell + s->gap;
+            continue;
+        }
+        const uint8_t *path = paths[i % (sizeof paths / sizeof paths[0])];
+        for (uint8_t k = 0; path[k] != 0xFF; k++) {
+            AddContact(path[k], t, t + s->dwell);
+            t += s->dwell - s->gap;
+        }
+        t += s->gap + 500;
+    }
+    runTicks = MS(t + START_MS + (s->count ? 0 : 5000));
+}
+
+// share of a finger on the pad at tick t, with the landing and lifting ramps
+static double Coverage(uint8_t pad, uint32_t t) {
+    double best = 0;
+    for (uint8_t i = 0; i < numContacts; i++) {
+        const Contact *c = &contacts[i];
+        if (c->pad != pad || t < c->start || t >= c->end) continue;
+        double rise = (double)(t - c->start) / MS(RAMP_MS);
+        double fall = (double)(c->end - t) / MS(RAMP_MS);
+        double v = rise < fall ? rise : fall;
+        if (v > 1) v = 1;
+        if (v > best) best = v;
+    }
+    return best;
+}
+
+static void WriteRecord(const uint8_t *rec, uint8_t n) {
+    fwrite(rec, 1, n, traceOut);
+}
+
+static void SyntheticFeed(uint32_t t) {
+    const Scenario *s = scenario;
+    double signal[NUM_TOUCHPADS], ring = 0;
+    static uint8_t spikePad, spikeScans;
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        signal[i] = s->signal * Coverage(i, t);
+        if (i < 4 && signal[i] > ring) ring = signal[i];
+    }
+    double center = signal[4];
+    signal[4] += ring * s->crosstalk / 100;
+    for (uint8_t i = 0; i < 4; i++) signal[i] += center * s->crosstalk / 100;
+    if (spikeScans) spikeScans--;
+    else if (s->spikes && Random() % 1000 < s->spikes) {
+        spikePad = Random() % NUM_TOUCHPADS;
+        spikeScans = 1 + Random() % 2;
+    }
+
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) {
+        double level = 560 + 30 * i + (double)s->drift * t / runTicks - signal[i];
+        if (spikeScans && i == spikePad) level -= 150;
+        double sum = 0;
+        for (uint8_t n = 0; n < TOUCH_OVERSAMPLE; n++) {
+            double v = level + s->noise * Gauss();
+            sum += v < 0 ? 0 : v > 1023 ? 1023 : (int)(v + 0.5);
+        }
+        modelSample[i] = sum;
+    }
+    if (traceOut) {
+        uint8_t rec[TRACE_MAX_RECORD];
+        TouchScan scan = { .pads = (1 << NUM_TOUCHPADS) - 1, .tick = t };
+        if (t % TRACE_HEADER_SCANS == 0)
+            WriteRecord(rec, Trace_EncodeHeader(rec, modelWindow));
+        for (uint8_t i = 0; i < NUM_TOUCHPADS; i++)
+            scan.raw[i] = modelSample[i] * (16 / TOUCH_OVERSAMPLE);
+        WriteRecord(rec, Trace_EncodeScan(rec, &scan));
+    }
+}
+
+// holds each pad's last recorded reading until the next one
+static void TraceFeed(uint32_t t) {
+    while (nextRecord < numRecords && records[nextRecord].tick <= t) {
+        const Record *r = &records[nextRecord++];
+        for (uint8_t i = 0; i < NUM_TOUCHPADS; i++)
+            if (r->pads & (1 << i)) modelSample[i] = r->sum[i];
+    }
+}
+
+static uint8_t Checked(const uint8_t *p, uint32_t n) {
+    uint8_t sum = 0;
+    while (n--) sum += *p++;
+    return sum == 0;
+}
+
+// Reads the scan records of a trace, resynchronising after damaged bytes.
+// The charge windows come from the last header before the first scan.
+static int LoadTrace(const char *name) {
+    FILE *f = fopen(name, "rb");
+    uint8_t *data;
+    long size;
+    uint32_t pos = 0, base = 0, last = 0, skipped = 0;
+    bool header = false;
+    if (!f) { perror(name); return -1; }
+    fseek(f, 0, SEEK_END); size = ftell(f); rewind(f);
+    data = malloc(size + 1);
+    records = malloc((size / 5 + 1) * sizeof(Record));
+    if (fread(data, 1, size, f) != (size_t)size) { fclose(f); return -1; }
+    fclose(f);
+    while (pos < (uint32_t)size) {
+        uint32_t len = 0;
+        if (data[pos] == TRACE_HEADER && pos + 4 <= (uint32_t)size)
+            len = 8 + 2 * data[pos + 3];
+        else if (data[pos] == TRACE_SCAN && pos + 4 <= (uint32_t)size)
+            len = 5 + 2 * __builtin_popcount(data[pos + 3]);
+        if (!len || pos + len > (uint32_t)size || !Checked(data + pos, len)
+                || (data[pos] == TRACE_SCAN && data[pos + 3] >> NUM_TOUCHPADS)) {
+            pos++; skipped++;
+            continue;
+        }
+        if (data[pos] == TRACE_HEADER) {
+            if (data[pos + 1] != 'T' || data[pos + 2] != TRACE_VERSION
+                    || data[pos + 3] != NUM_TOUCHPADS || data[pos + 6] != TOUCH_OVERSAMPLE) {
+                fprintf(stderr, "%s: trace of another build (version %u, %u pads, oversample %u)\n",
+                        name, data[pos + 2], data[pos + 3], data[pos + 6]);
+                return -1;
+            }
+            if (!numRecords)
+                for (uint8_t i = 0; i < NUM_TOUCHPADS; i++)
+                    modelWindow[i] = data[pos + 7 + 2 * i] | data[pos + 8 + 2 * i] << 8;
+            header = true;
+        } else if (header) {
+            Record *r = &records[numRecords];
+            uint16_t tick = data[pos + 1] | data[pos + 2] << 8;
+            const uint8_t *p = data + pos + 4;
+            if (!numRecords) base = tick;
+            else base += (uint16_t)(tick - last);  // 16 bit ticks wrap
+            last = tick;
+            r->tick = base;
+            r->pads = data[pos + 3];
+            for (uint8_t i = 0; i < NUM_TOUCHPADS; i++)
+                if (r->pads & (1 << i)) { r->sum[i] = p[0] | p[1] << 8; p += 2; }
+            numRecords++;
+        }
+        pos += len;
+    }
+    free(data);
+    if (!numRecords) { fprintf(stderr, "%s: no scans\n", name); return -1; }
+    if (skipped) fprintf(stderr, "%s: %u bytes skipped\n", name, skipped);
+    // ticks from the first scan on
+    for (uint32_t i = numRecords; i-- > 0; ) records[i].tick -= records[0].tick;
+    runTicks = records[numRecords - 1].tick + 1;
+    return 0;
+}
+
+static int LoadLabels(const char *name) {
+    FILE *f = fopen(name, "r");
+    unsigned start, end, pad;
+    char line[80];
+    if (!f) { perror(name); return -1; }
+    while (fgets(line, sizeof line, f))
+        if (sscanf(line, "%u %u %u", &start, &end, &pad) == 3 && pad < NUM_TOUCHPADS)
+            AddContact(pad, start, end);
+    fclose(f);
+    return 0;
+}
+
+static void WriteLabels(const char *name) {
+    FILE *f = fopen(name, "w");
+    if (!f) { perror(name); exit(1); }
+    for (uint8_t i = 0; i < numContacts; i++)
+        fprintf(f, "%u %u %u\n", contacts[i].start * 1000 / TOUCH_SCAN_HZ,
+                contacts[i].end * 1000 / TOUCH_SCAN_HZ, contacts[i].pad);
+    fclose(f);
+}
+
+// Runs the detection from power-up without a stored calibration, in
+// pattern entry, and collects the ticks of the PRESSes. The input layer
+// takes one scan per Touch_Update() here, so the scan of an event is the
+// tick just run.
+static void Run(void) {
+    TouchEvent ev;
+    modelFeed(0);
+    CTMUInit(NULL);
+    Touch_SetProfile(TOUCH_PROFILE_PATTERN);
+    while (modelTicks < runTicks) {
+        Touch_Update();
+        while (Touch_PollEvent(&ev))
+            if (ev.type == TOUCH_PRESS && numPresses < MAX_PRESSES)
+                presses[numPresses++] = (modelTicks - 1) << 3 | ev.pad;
+    }
+}
+
+static void Report(const char *label, const char *name, bool labelled) {
+    bool used[MAX_PRESSES] = { false };
+    uint16_t missed = 0, found = 0, falseTouches = 0;
+    uint32_t total = 0, worst = 0;
+    if (!labelled) {
+        printf("%s: %u presses\n", name, numPresses);
+        for (uint16_t k = 0; k < numPresses; k++)
+            printf("%8u ms  pad %u\n", (presses[k] >> 3) * 1000 / TOUCH_SCAN_HZ, presses[k] & 7);
+        return;
+    }
+    for (uint8_t i = 0; i < numContacts; i++) {
+        const Contact *c = &contacts[i];
+        uint16_t k;
+        for (k = 0; k < numPresses; k++) {
+            uint32_t t = presses[k] >> 3;
+            if (!used[k] && (presses[k] & 7) == c->pad
+                    && t >= c->start && t <= c->end + MS(MATCH_LATE_MS)) break;
+        }
+        if (k == numPresses) { missed++; continue; }
+        used[k] = true;
+        found++;
+        uint32_t latency = (presses[k] >> 3) - c->start;
+        total += latency;
+        if (latency > worst) worst = latency;
+    }
+    for (uint16_t k = 0; k < numPresses; k++) falseTouches += !used[k];
+    printf("%-26s %-12s %7u %6u %6u", label, name, numContacts, missed, falseTouches);
+    if (found)
+        printf("  %6.1f / %5.1f\n", total * 1000.0 / TOUCH_SCAN_HZ / found,
+               worst * 1000.0 / TOUCH_SCAN_HZ);
+    else
+        printf("       - / -\n");
+}
+
+// each run in its own process, the detection code starts from power-up
+static void RunScenario(const Scenario *s, const char *label, const char *write) {
+    pid_t pid;
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0) { perror("fork"); exit(1); }
+    if (pid > 0) { waitpid(pid, NULL, 0); return; }
+    scenario = s;
+    Build(s);
+    for (uint8_t i = 0; i < NUM_TOUCHPADS; i++) modelWindow[i] = TOUCH_CHARGE_TICKS;
+    if (write) {
+        char name[256];
+        snprintf(name, sizeof name, "%s.trc", write);
+        traceOut = fopen(name, "wb");
+        if (!traceOut) { perror(name); exit(1); }
+        snprintf(name, sizeof name, "%s.lbl", write);
+        WriteLabels(name);
+    }
+    modelFeed = SyntheticFeed;
+    Run();
+    if (traceOut) fclose(traceOut);
+    Report(label, s->name, true);
+    exit(0);
+}
+
+int main(int argc, char **argv) {
+    const char *label = "default", *only = NULL, *write = NULL;
+    bool quiet = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "l:qs:w:")) != -1) {
+        switch (opt) {
+            case 'l': label = optarg; break;
+            case 'q': quiet = true; break;
+            case 's': only = optarg; break;
+            case 'w': write = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-l label] [-q] [-s scenario [-w name]] [trace [labels]]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (write && !only) { fprintf(stderr, "-w needs a scenario (-s)\n"); return 2; }
+    if (!quiet)
+        printf("%-26s %-12s %7s %6s %6s  %s\n", "settings", "scenario",
+               "touches", "missed", "false", "latency ms mean / max");
+    if (optind < argc) {
+        const char *name = strrchr(argv[optind], '/');
+        if (LoadTrace(argv[optind]) < 0) return 1;
+        if (optind + 1 < argc && LoadLabels(argv[optind + 1]) < 0) return 1;
+        modelFeed = TraceFeed;
+        Run();
+        Report(label, name ? name + 1 : argv[optind], optind + 1 < argc);
+        return 0;
+    }
+    for (uint8_t i = 0; i < NUM_SCENARIOS; i++) {
+        if (only && strcmp(only, scenarios[i].name)) continue;
+        RunScenario(&scenarios[i], label, write);
+        if (only) return 0;
+    }
+    if (only) { fprintf(stderr, "no scenario %s\n", only); return 2; }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/* Host stand-in for the XC16 device header: the special function registers
+ * the display driver and the touch scanner touch are plain variables, the
+ * PMP data port goes to the controller model in SH1101AModel.c, the ADC
+ * results and the flags the scanner polls to the touch model in TouchModel.c. */
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct { unsigned BUSY:1, IRQM:2, INCM:2, MODE16:1, MODE:2, WAITB:2, WAITM:4, WAITE:2; } PMMODEBITS;
+typedef struct { unsigned PMPEN:1, PTRDEN:1, PTWREN:1; } PMCONBITS;
+typedef struct { unsigned TRISD2:1, TRISD11:1; } TRISDBITS;
+typedef struct { unsigned LATD2:1, LATD11:1; } LATDBITS;
+typedef struct { unsigned TRISB15:1; } TRISBBITS;
+typedef struct { unsigned LATB15:1; } LATBBITS;
+typedef struct { unsigned PMPIE:1; } IEC2BITS;
+typedef struct { unsigned PMPIF:1; } IFS2BITS;
+typedef struct { unsigned PMPIP:3; } IPC11BITS;
+
+extern volatile uint16_t PMMODE, PMAEN, PMCON;
+extern volatile PMMODEBITS PMMODEbits;
+extern volatile PMCONBITS PMCONbits;
+extern volatile TRISDBITS TRISDbits;
+extern volatile LATDBITS LATDbits;
+extern volatile TRISBBITS TRISBbits;
+extern volatile LATBBITS LATBbits;
+extern volatile IEC2BITS IEC2bits;
+extern volatile IFS2BITS IFS2bits;
+extern volatile IPC11BITS IPC11bits;
+
+// every PMDIN1 access of the driver is one cycle of the modelled bus
+void Model_Write(uint8_t data);
+uint8_t Model_Read(void);
+#define PMPWrite(data)  Model_Write(data)
+#define PMPRead()       Model_Read()
+
+typedef struct { unsigned ADON:1, DONE:1, SAMP:1, FORM:2; } AD1CON1BITS;
+typedef struct { unsigned SMPI:4; } AD1CON2BITS;
+typedef struct { unsigned CTMUEN:1, IDISSEN:1, EDG1STAT:1, EDG2STAT:1; } CTMUCONBITS;
+typedef struct { unsigned IRNG:2, ITRIM:6; } CTMUICONBITS;
+typedef struct { unsigned TON:1; } TCONBITS;
+typedef struct { unsigned T3IF:1, AD1IF:1, OC1IF:1; } IFS0BITS;
+typedef struct { unsigned T3IE:1, AD1IE:1, OC1IE:1; } IEC0BITS;
+typedef struct { unsigned OC1IP:3; } IPC0BITS;
+typedef struct { unsigned T3IP:3; } IPC2BITS;
+typedef struct { unsigned AD1IP:3; } IPC3BITS;
+
+extern volatile uint16_t TRISB, AD1PCFGL, CTMUCON, AD1CON1, AD1CON2, AD1CON3, AD1CHS, AD1CSSL;
+extern volatile uint16_t T3CON, TMR3, PR3;
+extern volatile uint16_t OC1CON1, OC1CON2, OC1TMR, OC1R, OC1RS;
+extern volatile AD1CON2BITS AD1CON2bits;
+extern volatile CTMUCONBITS CTMUCONbits;
+extern volatile CTMUICONBITS CTMUICONbits;
+extern volatile TCONBITS T3CONbits;
+extern volatile IEC0BITS IEC0bits;
+extern volatile IPC0BITS IPC0bits;
+extern volatile IPC2BITS IPC2bits;
+extern volatile IPC3BITS IPC3bits;
+
+// conversions and charge windows end as soon as the scanner looks, the
+// results come from the readings the harness set for the pads
+volatile AD1CON1BITS *Model_AD1CON1(void);
+volatile IFS0BITS *Model_IFS0(void);
+volatile uint16_t *Model_ADCBuffer(void);
+#define AD1CON1bits     (*Model_AD1CON1())
+#define IFS0bits        (*Model_IFS0())
+#define ADC1BUF0        (Model_ADCBuffer()[0])
+
+// waiting for the next scan runs the next Timer3 tick
+void TouchModel_Tick(void);
+#define Idle()          TouchModel_Tick()
+#define Nop()
+#define SET_AND_SAVE_CPU_IPL(save, ipl)  ((save) = (ipl))
+#define RESTORE_CPU_IPL(save)            ((void)(save))
+
+// the ISR attributes mean nothing here; x86 gcc has its own "interrupt"
+#define __interrupt__   __used__
+#define no_auto_psv     __used__
+
+#endif
@@ -0,0 +1,39 @@
+/* Generated by img2c.py on 2026-10-15 23:22:20.982716 */
+#include "icons.h"
+
+// lock.pbm, 32 bytes raw: 32 bytes
+const uint8_t IMG_LOCK[32] = {
+    0x10, 0x02, 0x00, 0x00, 0x80, 0xC0, 0x02, 0xFC, 0xFE, 0xC7, 0x82, 0xC3, 0x02, 0xC7, 0xFE, 0xFC,
+    0x80, 0xC0, 0x80, 0x00, 0x83, 0x7F, 0x00, 0x79, 0x80, 0x60, 0x00, 0x79, 0x83, 0x7F, 0x00, 0x00,
+};
+
+// logo.pbm, 1024 bytes raw: 240 bytes
+const uint8_t IMG_LOGO[240] = {
+    0x80, 0x08, 0xBB, 0x00, 0x01, 0xE0, 0xF0, 0x81, 0xF8, 0x01, 0xF0, 0xE0, 0xEF, 0x00, 0x02, 0x80,
+    0x40, 0x20, 0x80, 0x10, 0x02, 0x08, 0x04, 0x02, 0x80, 0x01, 0x81, 0x03, 0x80, 0x01, 0x02, 0x02,
+    0x04, 0x08, 0x80, 0x10, 0x02, 0x20, 0x40, 0x80, 0xDB, 0x00, 0x01, 0xE0, 0xF0, 0x81, 0xF8, 0x80,
+    0xF0, 0x02, 0x08, 0x04, 0x02, 0x80, 0x01, 0x86, 0x00, 0x01, 0xE0, 0xF0, 0x81, 0xF8, 0x01, 0xF0,
+    0xE0, 0x86, 0x00, 0x80, 0x01, 0x02, 0x02, 0x04, 0x08, 0x80, 0xF0, 0x81, 0xF8, 0x01, 0xF0, 0xE0,
+    0xD0, 0x00, 0x00, 0x01, 0x81, 0x03, 0x00, 0x01, 0x8D, 0x00, 0x00, 0x01, 0x81, 0x03, 0x00, 0x01,
+    0x84, 0x00, 0x02, 0x80, 0x40, 0x20, 0x80, 0x10, 0x02, 0x08, 0x04, 0x02, 0x80, 0x01, 0x81, 0x03,
+    0x00, 0x01, 0xE4, 0x00, 0x01, 0xE0, 0xF0, 0x81, 0xF8, 0x80, 0xF0, 0x02, 0x08, 0x04, 0x02, 0x80,
+    0x01, 0xF3, 0x00, 0x00, 0x01, 0x81, 0x03, 0x00, 0x01, 0xDD, 0x00, 0x00, 0x18, 0x81, 0x24, 0x02,
+    0xC4, 0x00, 0xFC, 0x81, 0x24, 0x02, 0x04, 0x00, 0xF8, 0x81, 0x04, 0x08, 0x88, 0x00, 0xFC, 0x24,
+    0x64, 0xA4, 0x18, 0x00, 0xFC, 0x81, 0x24, 0x01, 0x04, 0x00, 0x80, 0x04, 0x00, 0xFC, 0x80, 0x04,
+    0x85, 0x00, 0x06, 0xFC, 0x20, 0x50, 0x88, 0x04, 0x00, 0xFC, 0x81, 0x24, 0x06, 0x04, 0x00, 0x1C,
+    0x20, 0xC0, 0x20, 0x1C, 0xC3, 0x00, 0x82, 0x01, 0x80, 0x00, 0x83, 0x01, 0x80, 0x00, 0x81, 0x01,
+    0x80, 0x00, 0x00, 0x01, 0x81, 0x00, 0x01, 0x01, 0x00, 0x83, 0x01, 0x81, 0x00, 0x00, 0x01, 0x87,
+    0x00, 0x00, 0x01, 0x81, 0x00, 0x01, 0x01, 0x00, 0x83, 0x01, 0x81, 0x00, 0x00, 0x01, 0xA3, 0x00,
+};
+
+// unlock.pbm, 32 bytes raw: 28 bytes
+const uint8_t IMG_UNLOCK[28] = {
+    0x10, 0x02, 0x00, 0x00, 0x84, 0xC0, 0x02, 0xFC, 0xFE, 0xC7, 0x82, 0xC3, 0x02, 0xC7, 0x0E, 0x00,
+    0x83, 0x7F, 0x00, 0x79, 0x80, 0x60, 0x00, 0x79, 0x83, 0x7F, 0x00, 0x00,
+};
+
+// user.pbm, 8 bytes raw: 10 bytes
+const uint8_t IMG_USER[10] = {
+    0x08, 0x01, 0x01, 0x80, 0xCE, 0x82, 0xDF, 0x01, 0xCE, 0x80,
+};
+
@@ -0,0 +1,13 @@
+/* Generated by img2c.py on 2026-10-15 23:22:20.982361 */
+#ifndef ICONS_H
+#define ICONS_H
+
+#include <stdint.h>
+
+// Run-length coded page images of icons/*.pbm, drawn with DrawImage(x, y, ...)
+extern const uint8_t IMG_LOCK[32];  // 16x16
+extern const uint8_t IMG_LOGO[240];  // 128x64
+extern const uint8_t IMG_UNLOCK[28];  // 16x16
+extern const uint8_t IMG_USER[10];  // 8x8
+
+#endif // ICONS_H
@@ -0,0 +1,84 @@
+import os
+import re
+import datetime
+
+from scr2c import Canvas, encode_image, c_array
+
+ICON_DIR = 'icons'
+
+def read_pbm(filename):
+    """Reads a plain (P1) or raw (P4) PBM file. Returns width, height and the
+    rows as lists of 0/1, 1 being a lit pixel."""
+    with open(filename, 'rb') as f:
+        data = f.read()
+    magic = data[:2]
+    if magic not in (b'P1', b'P4'):
+        raise ValueError(f"{filename}: not a PBM file")
+    # header: magic, width, height, separated by whitespace and comments
+    header = re.match(rb'P[14](?:\s+|#[^\n]*\n)*(\d+)(?:\s+|#[^\n]*\n)+(\d+)\s', data)
+    width, height = int(header.group(1)), int(header.group(2))
+    body = data[header.end():]
+    if magic == b'P1':
+        bits = [int(c) for c in re.sub(rb'#[^\n]*', b'', body).decode('ascii') if c in '01']
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+    else:
+        stride = (width + 7) // 8
+        rows = [[(body[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)]
+                for y in range(height)]
+    return width, height, rows
+
+def image_canvas(filename):
+    """Page image of a PBM file, the last page is padded with dark rows."""
+    width, height, rows = read_pbm(filename)
+    c = Canvas(width, (height + 7) // 8)
+    for y, row in enumerate(rows):
+        for x, bit in enumerate(row):
+            if bit:
+                c.pixel(x, y)
+    return c
+
+def generate_c_files():
+    files = sorted(f for f in os.listdir(ICON_DIR) if f.endswith('.pbm'))
+    if not files:
+        print(f"No .pbm files in {ICON_DIR}/. Aborting.")
+        return
+    images = []
+    for name in files:
+        c = image_canvas(os.path.join(ICON_DIR, name))
+        key = 'IMG_' + re.sub(r'\W', '_', os.path.splitext(name)[0]).upper()
+        images.append((key, name, c, encode_image(c)))
+
+    # --- Header File (.h) ---
+    h_content = f"""/* Generated by img2c.py on {datetime.datetime.now()} */
+#ifndef ICONS_H
+#define ICONS_H
+
+#include <stdint.h>
+
+// Run-length coded page images of {ICON_DIR}/*.pbm, drawn with DrawImage(x, y, ...)
+"""
+    for key, name, c, data in images:
+        h_content += f"extern const uint8_t {key}[{len(data)}];  // {c.width}x{len(c.pages) * 8}\n"
+    h_content += """
+#endif // ICONS_H
+"""
+    with open('icons.h', 'w') as f:
+        f.write(h_content)
+
+    # --- Source File (.c) ---
+    c_content = f"""/* Generated by img2c.py on {datetime.datetime.now()} */
+#include "icons.h"
+
+"""
+    total = 0
+    for key, name, c, data in images:
+        total += len(data)
+        raw = c.width * len(c.pages)
+        c_content += c_array(key, data, f'{name}, {raw} bytes raw') + '\n'
+    with open('icons.c', 'w') as f:
+        f.write(c_content)
+
+    print(f"Generated icons.h and icons.c successfully ({total} bytes).")
+
+if __name__ == "__main__":
+    generate_c_files()
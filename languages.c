@@ -1,4 +1,4 @@
-/* Generated by po2c.py on 2026-02-07 04:33:28.887316 */
+/* Generated by po2c.py on 2026-10-15 23:56:17.152028 */
 #include "languages.h"
 
 // --- DEFINITION OF GLOBAL VARIABLE ---
@@ -58,6 +58,7 @@ const char* UI_STRINGS[2][S_COUNT] = {
         "Rem:", // S_REMAINING
         "Login as User 1", // S_M_LOGIN_U1
         "Login as User 2", // S_M_LOGIN_U2
+        "Pattern in use", // S_PASS_TAKEN
     },
     { // German
         "Willkommen!", // S_WELCOME
@@ -112,5 +113,6 @@ const char* UI_STRINGS[2][S_COUNT] = {
         "Verb:", // S_REMAINING
         "Login als User 1", // S_M_LOGIN_U1
         "Login als User 2", // S_M_LOGIN_U2
+        "Muster vergeben", // S_PASS_TAKEN
     }
 };
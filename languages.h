@@ -1,4 +1,4 @@
-/* Generated by po2c.py on 2026-02-07 04:33:28.886949 */
+/* Generated by po2c.py on 2026-10-15 23:56:17.151596 */
 #ifndef LANGUAGES_H
 #define LANGUAGES_H
 
@@ -61,6 +61,7 @@ enum StrID {
     S_REMAINING = 49,
     S_M_LOGIN_U1 = 50,
     S_M_LOGIN_U2 = 51,
+    S_PASS_TAKEN = 52,
     S_COUNT
 };
 
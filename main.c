@@ -3,9 +3,20 @@
 #include <stdbool.h>
 
 // --- Configuration ---
-#define DEBOUNCE_THRESH  4      // Cycles a touch must be stable to register
-#define TOUCH_TIMEOUT    5000  // Cycles to wait after release before submitting pattern
-#define RESULT_DELAY     20000   // Cycles to hold result display
+#define PATTERN_IDLE_MS  1250  // Pause after the last node that submits a pattern
+#define NEW_PATTERN_IDLE_MS 1500  // ... and a new password
+#ifndef DOOR_IDENTIFY_USER
+#define DOOR_IDENTIFY_USER 0   // 1: the door takes any user's pattern, no menu to pick the user first
+#endif
+#define MENU_HOLD_MS     1500  // ... there, holding the center this long opens the door menu
+#define PASS_TAKEN_MAX   3     // ... and new patterns refused as another user's until the door signs out
+#ifndef PATTERN_INSTANT_REJECT
+#define PATTERN_INSTANT_REJECT 0  // 1 submits a pattern at its first wrong node
+#endif
+#define RESULT_HOLD_MS   640   // How long result screens stay up
+#define SAVED_HOLD_MS    320   // ... and the password saved message
+#define LOGO_HOLD_MS     640   // ... and the boot logo
+#define FADE_STEP_MS     20    // LED fade of a result screen, one step
 #define PATTERN_MAX      5     // Max nodes in a pattern
 #define MAX_USERS        3     // Max num. of users that can be created
 #define MAX_LOGS         15    // Max num. of entris of Logs
@@ -27,6 +38,9 @@ const uint8_t btnY[5] = {12, 32, 52, 32, 32};  // Y positions
 #define FLASH_PAGE_SIZE 512 
 
 const uint16_t __attribute__((space(prog), aligned(1024))) FlashStorage[FLASH_PAGE_SIZE] = {0xFFFF};
+// Touch calibration in a page of its own, so neither record erases the other
+#define CAL_MAGIC       0xCA1C
+const uint16_t __attribute__((space(prog), aligned(1024))) CalStorage[FLASH_PAGE_SIZE] = {0xFFFF};
 
 #define BCDToBin(x)     ( (((x) >> 4) * 10) + ((x) & 0x0F) )
 #define BinToBCD(x)     ( (((x) / 10) << 4) | ((x) % 10) )
@@ -56,16 +70,19 @@ enum AppState {
     STATE_VERIFY_DOOR,    
     STATE_VERIFY_LOGIN,   
     
-    STATE_ERROR_MSG       
+    STATE_ERROR_MSG,
+
+    STATE_COUNT
 };
 
 uint8_t current_state = STATE_BOOT;
 uint8_t returnState = STATE_MENU;
 
 // Debounce / Input Globals
-int8_t lastSeenButton = -1;
-uint8_t stableCount = 0;
-uint32_t idleTimer = 0;
+bool nodeHeld;          // the last node is touched, the pause has not begun
+uint32_t nodeAt;        // Tick_Ms() the last node was touched ...
+uint32_t releasedAt;    // ... and let go
+bool doorAnyUser;       // the door pattern finds the user, see DOOR_IDENTIFY_USER
 
 // --- USER DATA ---
 uint8_t PASSWORDS[MAX_USERS][PATTERN_MAX];
@@ -83,6 +100,8 @@ uint8_t USER_ACTIVE[MAX_USERS];
 uint8_t numUsers = 0;    
 uint8_t currentUser = 0; 
 uint8_t targetUserIdx = 0; 
+uint8_t passTaken;       // new patterns refused as taken, see SetPatternEnter()
+#define USER_NONE MAX_USERS  // no user's pattern, at the door; fits the 2 bits of a log entry
 
 // --- LOG DATA ---
 typedef struct {
@@ -128,6 +147,14 @@ uint8_t menuIndex = 0;
 int8_t dynamicMenuMap[MAX_MENU_ITEMS]; 
 char dynamicMenuLabels[MAX_MENU_ITEMS][32]; 
 
+// Retained menu view: the row the cursor is drawn at (-1 if none), so moving
+// it only touches the old and the new cursor cell instead of the screen
+int8_t menuCursorY = -1;
+
+// User config rows and the values currently drawn in them
+const uint8_t cfgRowY[5] = { 12, 22, 32, 42, 55 };
+uint8_t cfgShownActive, cfgShownPerm, cfgShownAccType, cfgShownAccCount;
+
 // --- MENUS ---
 const uint8_t menuItemsAdmin[] = { S_M_CHANGE_PASS, S_M_CREATE_USER, S_M_ADVANCED, S_M_LANG, S_M_EXIT };
 #define MENU_COUNT_ADMIN 5
@@ -142,23 +169,46 @@ const uint8_t menuItemsUserRestricted[] = { S_M_LANG, S_M_LOGIN_SESSIONS, S_M_EX
 // --- Helper Prototypes ---
 void NVM_WriteAll(void);
 bool NVM_ReadAll(void);
+void NVM_WriteCal(const TouchCal *cal);
+bool NVM_ReadCal(TouchCal *cal);
 void RTCC_Init(void);
 void RTCC_Set(uint8_t y, uint8_t m, uint8_t d, uint8_t h, uint8_t min);
 void RTCC_ReadTime(uint8_t* m, uint8_t* d, uint8_t* h, uint8_t* min); 
 void Log_Add(uint8_t userIdx, uint8_t type, uint8_t status); 
-void UI_DrawString(int x, int y, char* str);
-void UI_PrintNum(int x, int y, int num, bool leadingZero);
-void UI_ResetGrid(void);
-void GFX_DrawLine(int x0, int y0, int x1, int y1);
-void GFX_DrawNode(uint8_t x, uint8_t y, bool filled);
-void delay(unsigned int delay_count);
+void Pattern_Reset(void);
+void State_Go(uint8_t next);
+void UI_Hold(uint16_t ms, uint8_t next);
 
 // --- FLASH MEMORY FUNCTIONS ---
+bool nvmDirty;       // changed since the last NVM_WriteAll()
+SoftTimer nvmTimer;  // writes it on the next pass
+
 void NVM_Unlock() { __builtin_write_NVM(); }
 
+// erases the page at page:off and writes buffer to its first row
+void NVM_WriteRow(uint16_t page, uint16_t off, const uint16_t *buffer) {
+    uint16_t i;
+    // Erase Page
+    NVMCON = 0x4042; 
+    TBLPAG = page; 
+    __builtin_tblwtl(off, 0xFFFF); 
+    NVM_Unlock(); 
+    while(NVMCONbits.WR);
+
+    // Write Row
+    NVMCON = 0x4001; 
+    TBLPAG = page; 
+    for(i=0; i<FLASH_ROW_SIZE; i++) 
+        __builtin_tblwtl(off + (i*2), buffer[i]);
+    
+    NVM_Unlock(); 
+    while(NVMCONbits.WR);
+}
+
 void NVM_WriteAll() {
     uint16_t buffer[FLASH_ROW_SIZE];
     uint16_t i;
+    nvmDirty = false;
     
     // Prepare Buffer
     for(i=0; i<FLASH_ROW_SIZE; i++) buffer[i] = 0xFFFF;
@@ -211,23 +261,12 @@ void NVM_WriteAll() {
         buffer[offset++] = wordB;
     }
     
-    // Erase Page
-    NVMCON = 0x4042; 
-    TBLPAG = __builtin_tblpage(FlashStorage); 
-    __builtin_tblwtl(__builtin_tbloffset(FlashStorage), 0xFFFF); 
-    NVM_Unlock(); 
-    while(NVMCONbits.WR);
+    NVM_WriteRow(__builtin_tblpage(FlashStorage), __builtin_tbloffset(FlashStorage), buffer);
+}
 
-    // Write Row
-    NVMCON = 0x4001; 
-    TBLPAG = __builtin_tblpage(FlashStorage); 
-    uint16_t flashOff = __builtin_tbloffset(FlashStorage);
-    
-    for(i=0; i<FLASH_ROW_SIZE; i++) 
-        __builtin_tblwtl(flashOff + (i*2), buffer[i]);
-    
-    NVM_Unlock(); 
-    while(NVMCONbits.WR);
+// for changes that can wait for the next pass of the main loop
+void NVM_WriteDirty(void) {
+    if (nvmDirty) NVM_WriteAll();
 }
 
 bool NVM_ReadAll() {
@@ -294,6 +333,49 @@ bool NVM_ReadAll() {
     return false; 
 }
 
+// --- TOUCH CALIBRATION ---
+// Word 0: magic, then baseline, trip point, noise and charge window per
+// pad, then the two's complement of the sum of all words before it
+void NVM_WriteCal(const TouchCal *cal) {
+    uint16_t buffer[FLASH_ROW_SIZE];
+    uint16_t sum = CAL_MAGIC;
+    int offset = 0;
+
+    for(int i=0; i<FLASH_ROW_SIZE; i++) buffer[i] = 0xFFFF;
+    buffer[offset++] = CAL_MAGIC;
+    for(int p=0; p<NUM_TOUCHPADS; p++) {
+        buffer[offset++] = cal->baseline[p];
+        buffer[offset++] = cal->trip[p];
+        buffer[offset++] = cal->noise[p];
+        buffer[offset++] = cal->charge[p];
+        sum += cal->baseline[p] + cal->trip[p] + cal->noise[p] + cal->charge[p];
+    }
+    buffer[offset] = -sum;
+    NVM_WriteRow(__builtin_tblpage(CalStorage), __builtin_tbloffset(CalStorage), buffer);
+}
+
+bool NVM_ReadCal(TouchCal *cal) {
+    uint16_t ptr = __builtin_tbloffset(CalStorage);
+    TBLPAG = __builtin_tblpage(CalStorage);
+    uint16_t magic = __builtin_tblrdl(ptr); ptr += 2;
+    uint16_t sum = magic;
+
+    if (magic != CAL_MAGIC) return false;
+    for(int p=0; p<NUM_TOUCHPADS; p++) {
+        cal->baseline[p] = __builtin_tblrdl(ptr); ptr += 2;
+        cal->trip[p]     = __builtin_tblrdl(ptr); ptr += 2;
+        cal->noise[p]    = __builtin_tblrdl(ptr); ptr += 2;
+        cal->charge[p]   = __builtin_tblrdl(ptr); ptr += 2;
+        sum += cal->baseline[p] + cal->trip[p] + cal->noise[p] + cal->charge[p];
+        // Safety check: values the scanner could have learned
+        if (cal->trip[p] < TOUCH_TRIP_MIN || cal->trip[p] > TOUCH_TRIP_MAX) return false;
+        if (cal->noise[p] > TOUCH_TRIP_MAX || cal->baseline[p] == 0) return false;
+        if (cal->charge[p] < TOUCH_CHARGE_MIN || cal->charge[p] > TOUCH_CHARGE_MAX) return false;
+    }
+    sum += __builtin_tblrdl(ptr);
+    return sum == 0;
+}
+
 // --- RTCC & LOG HELPER ---
 void RTCC_Init() {
     __builtin_write_OSCCONL(OSCCON | 0x02);
@@ -341,117 +423,159 @@ void Log_Add(uint8_t userIdx, uint8_t type, uint8_t status) {
     ADMIN_LOGS[0].type = type;
     ADMIN_LOGS[0].status = status;
     RTCC_ReadTime(&ADMIN_LOGS[0].mon, &ADMIN_LOGS[0].day, &ADMIN_LOGS[0].hour, &ADMIN_LOGS[0].min);
-    NVM_WriteAll();
+    nvmDirty = true;
+    Timer_Start(&nvmTimer, 0, 0, NVM_WriteDirty);  // after the result is on screen
 }
 
-// --- Graphic Helpers ---
+// Start of a full menu repaint: the screen holds no cursor yet
+void UI_MenuBegin(void) {
+    menuCursorY = -1;
+}
 
-// Bresenham's Line Algorithm
-void GFX_DrawLine(int x0, int y0, int x1, int y1) {
-    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy, e2;
+// Inverts the cursor cell, one character wide and 9 pixels high, in front
+// of the label of the text row at y
+#define UI_InvertCursor(y) InvertRect(2, (y) - 1, 7, (y) + 7)
 
-    for (;;) {
-        PutPixel(x0, y0);
-        if (x0 == x1 && y0 == y1) break;
-        e2 = 2 * err;
-        if (e2 >= dy) { err += dy; x0 += sx; }
-        if (e2 <= dx) { err += dx; y0 += sy; }
-    }
+// Move the menu cursor to the text row at y (y < 0 hides it)
+void UI_MenuCursor(int y) {
+    if (y == menuCursorY) return;
+    if (menuCursorY >= 0) UI_InvertCursor(menuCursorY);  // restore the old cell
+    if (y >= 0) UI_InvertCursor(y);
+    menuCursorY = y;
 }
 
-// Draw Node (Hollow or Filled)
-void GFX_DrawNode(uint8_t x, uint8_t y, bool filled) {
-    // Draw Node Outline (Cross-like shape)
-    PutPixel(x, y-3); PutPixel(x, y+3);
-    PutPixel(x-3, y); PutPixel(x+3, y);
-    PutPixel(x-1, y-2); PutPixel(x+1, y-2);
-    PutPixel(x-2, y-1); PutPixel(x+2, y-1);
-    PutPixel(x-2, y+1); PutPixel(x+2, y+1);
-    PutPixel(x-1, y+2); PutPixel(x+1, y+2);
-
-    if (filled) {
-        PutPixel(x, y);
-        PutPixel(x-1, y); PutPixel(x+1, y);
-        PutPixel(x, y-1); PutPixel(x, y+1);
+// --- Log Viewer ---
+// The log views are laid out on whole display pages: page 0 holds the title
+// and its rule, pages 1..7 one entry each. Scrolling by one entry moves the
+// display start line by a page, so only the header and the entry that
+// wrapped around to the other edge have to be repainted.
+#define LOG_VIEW_ROWS 7
+
+// Formats the n-th entry of the admin or the user log view, false if none
+bool UI_LogLine(bool userView, int n, char* buf) {
+    int k = n;
+    if (userView) {
+        for (k = 0; k < logCount; k++)
+            if (ADMIN_LOGS[k].userIdx == currentUser && n-- == 0) break;
+    }
+    if (k >= logCount) return false;
+    LogEntry l = ADMIN_LOGS[k];
+    char tStr[3] = "St"; if (l.type == LOG_TYPE_DOOR) sprintf(tStr, "Dr");
+    char sStr[3] = "XX"; if (l.status == LOG_STATUS_SUCCESS) sprintf(sStr, "OK");
+    if (userView) {
+        sprintf(buf, "%02d/%02d %02d:%02d %s %s", l.mon, l.day, l.hour, l.min, tStr, sStr);
+    } else {
+        char uStr[3] = "Ad";
+        if (l.userIdx == 1) sprintf(uStr, "G1");
+        if (l.userIdx == 2) sprintf(uStr, "G2");
+        if (l.userIdx == USER_NONE) sprintf(uStr, "--");
+        sprintf(buf, "%s %02d/%02d %02d:%02d %s %s", uStr, l.mon, l.day, l.hour, l.min, tStr, sStr);
     }
+    return true;
 }
 
-// Draw a single character from the font array
-void UI_DrawChar(int x, int y, char c) { 
-    // Cast to unsigned to handle extended ASCII (128-255) safely
-    uint8_t uc = (uint8_t)c;
-    
-    // Check range: 32 (Space) to 129 ()
-    if (uc < 32 || uc > 129) uc = 32; 
-    
-    int index = uc - 32; 
-    
-    for (int i = 0; i < 5; i++) { 
-        uint8_t line = Font5x7[index][i]; 
-        for (int j = 0; j < 8; j++)
-            if (line & (1 << j))
-                PutPixel(x + i, y + j); 
-    } 
-}
-
-// Draw a string of text
-void UI_DrawString(int x, int y, char* str) {
-    while (*str) {
-        UI_DrawChar(x, y, *str);
-        x += 6; // 5px width + 1px spacing
-        str++;
+// Repaints page r of a log view scrolled to entry 'top', page 0 is the header
+void UI_LogRow(bool userView, uint8_t r, int top) {
+    char buf[25];
+    int y = r * 8;
+    SetColor(BLACK); FillRect(0, y, DISP_HOR_RESOLUTION - 1, y + 7); SetColor(WHITE);
+    if (r == 0) {
+        UI_DrawString(2, 0, "<");  // left goes back
+        if (userView) UI_DrawString(20, 0, (char*)GetStr(S_M_LOGIN_SESSIONS));
+        else UI_DrawString(30, 0, (char*)GetStr(S_LOGS_TITLE));
+        GFX_DrawLine(0, 7, 127, 7);
     }
+    else if (UI_LogLine(userView, top + r - 1, buf)) UI_DrawString(2, y, buf);
+    else if (r == 1) UI_DrawString(10, y, (char*)GetStr(S_LOGS_NONE));
 }
 
-void UI_PrintNum(int x, int y, int num, bool leadingZero) {
-    char buf[5];
-    if (leadingZero)
-        sprintf(buf, "%02d", num);
-    else
-        sprintf(buf, "%d", num);
-    UI_DrawString(x, y, buf);
+// Scrolls a log view by one entry to the new 'top' through the start line
+void UI_LogScroll(bool userView, int top, bool down) {
+    ScrollDevice(down ? 8 : -8);
+    UI_LogRow(userView, 0, top);
+    UI_LogRow(userView, down ? LOG_VIEW_ROWS : 1, top);
 }
 
-// Reset screen grid to initial state
-void UI_ResetGrid() {
-    SetColor(BLACK); 
-    ClearDevice(); 
-    SetColor(WHITE);
-    
+// Starts a new pattern, the grid is drawn by the pattern states
+void Pattern_Reset() {
     for(int i=0; i<5; i++) {
-        GFX_DrawNode(btnX[i], btnY[i], false);
         visitedMask[i] = false;
     }
     patternIdx = 0;
-    idleTimer = 0;
+    nodeHeld = true;
 }
-// Helper to get single stable button press (filters noise where multiple pads trigger)
-int8_t GetStableInput() {
-    int8_t detected = -1;
-    uint8_t pressCount = 0;
 
-    for (uint8_t i = 0; i < 5; i++) {
-        if (buttons[i]) {
-            detected = i;
-            pressCount++;
-        }
+// --- Pattern matching ---
+// The pattern is matched node by node as it is entered, against the stored
+// patterns of a set of candidate users. Each step does the same work whatever
+// the patterns hold: every slot is compared and the results are combined
+// as masks without branches, so its time does not tell how far a prefix
+// matched.
+#define MATCH_PENDING 0  // more nodes can still decide it
+#define MATCH_ACCEPT  1  // one candidate matches and none is longer
+#define MATCH_REJECT  2  // no candidate starts with these nodes
+
+uint8_t matchAlive;    // candidates whose pattern starts with the nodes so far, bit n = user n
+bool matchExact;       // exactly one candidate's pattern is the nodes so far ...
+uint8_t matchUser;     // ... this one
+uint8_t matchResult;
+
+// 0xFFFF if a == b, else 0; a, b < 0x8000
+static uint16_t Ct_Eq(uint16_t a, uint16_t b) {
+    uint16_t d = a ^ b;
+    return ((uint16_t)(d | -d) >> 15) - 1;
+}
+
+// 0xFFFF if a < b, else 0; a, b < 0x8000
+static uint16_t Ct_Less(uint16_t a, uint16_t b) {
+    return -((uint16_t)(a - b) >> 15);
+}
+
+void Match_Begin(uint8_t candidates) {
+    matchAlive = candidates;
+    matchExact = false; matchUser = 0;
+    matchResult = MATCH_PENDING;
+}
+
+// Takes node number pos of the pattern, returns MATCH_*
+uint8_t Match_Node(uint8_t pos, uint8_t node) {
+    uint16_t alive = 0, exact = 0, longer = 0, user = 0;
+    for (uint8_t u = 0; u < MAX_USERS; u++) {
+        uint16_t bit = 1 << u;
+        uint16_t m = ~Ct_Eq(matchAlive & bit, 0) & Ct_Less(pos, PASS_LENS[u]) & Ct_Eq(PASSWORDS[u][pos], node);
+        uint16_t ends = m & Ct_Eq(PASS_LENS[u], pos + 1);
+        alive |= m & bit;
+        exact |= ends & bit;
+        longer |= m & Ct_Less(pos + 1, PASS_LENS[u]) & bit;
+        user |= ends & u;
     }
+    uint16_t single = ~Ct_Eq(exact, 0) & Ct_Eq(exact & (exact - 1), 0);
+    matchAlive = alive;
+    matchExact = single & 1;
+    matchUser = user;
+    matchResult = (single & Ct_Eq(longer, 0) & MATCH_ACCEPT) | (Ct_Eq(alive, 0) & MATCH_REJECT);
+    return matchResult;
+}
 
-    // Ignore if multiple pads are triggered (noise reduction)
-    if (pressCount > 1) return -1;
-    
-    return detected;
+// Users with a pattern stored, active or not, bit n = user n
+uint8_t Users_PatternStored(void) {
+    uint8_t mask = 0;
+    for (uint8_t u = 0; u < numUsers; u++)
+        if (PASS_LENS[u] > 0) mask |= 1 << u;
+    return mask;
 }
 
+// Users the door opens for with their pattern, bit n = user n
+uint8_t Users_WithPattern(void) {
+    uint8_t mask = Users_PatternStored();
+    for (uint8_t u = 0; u < numUsers; u++)
+        if (!USER_ACTIVE[u]) mask &= ~(1 << u);
+    return mask;
+}
+
+// The pattern as entered is the one of userIdx
 bool CheckPassword(uint8_t userIdx) {
-    if (patternIdx != PASS_LENS[userIdx]) return false;
-    for (uint8_t k=0; k<PASS_LENS[userIdx]; k++) {
-        if (patternBuf[k] != PASSWORDS[userIdx][k])
-            return false;
-    }
-    return true;
+    return matchExact && matchUser == userIdx;
 }
 
 void SavePassword(uint8_t userIdx) { 
@@ -470,12 +594,37 @@ void SavePassword(uint8_t userIdx) {
     NVM_WriteAll(); 
 }
 
-// Blocking Delay
-void delay(unsigned int delay_count) {
-    T1CON = 0x8030; // Timer 1 ON, Prescale 1:256
-    TMR1 = 0;
-    while(TMR1 < delay_count);
-    T1CON = 0;
+// --- Holding a screen ---
+// A result screen stays up for a while with its LED color fading to the idle
+// blue, then the app moves on. Nothing blocks meanwhile: touches are scanned
+// (and dropped), timers and flash writes go on, and the next state takes
+// touches the moment the hold ends.
+SoftTimer holdTimer, fadeTimer;
+uint8_t holdNext;   // state after the hold
+uint8_t fadeR, fadeG, fadeB;
+
+void HoldEnd(void) {
+    Timer_Stop(&fadeTimer);
+    State_Go(holdNext);
+}
+
+void FadeStep(void) {
+    fadeR -= (fadeR + 7) >> 3; fadeG -= (fadeG + 7) >> 3; fadeB += (255 - fadeB + 7) >> 3;
+    SetRGBs(fadeR, fadeG, fadeB);
+}
+
+// Keeps what is on screen and the LED color set with it for ms, then
+// switches to state next
+void UI_Hold(uint16_t ms, uint8_t next) {
+    holdNext = next;
+    Timer_Start(&holdTimer, ms, 0, HoldEnd);
+    Timer_Start(&fadeTimer, FADE_STEP_MS, FADE_STEP_MS, FadeStep);
+}
+
+// Sets the LED and remembers the color for the fade of UI_Hold()
+void UI_ResultLED(uint8_t r, uint8_t g, uint8_t b) {
+    fadeR = r; fadeG = g; fadeB = b;
+    SetRGBs(r, g, b);
 }
 
 // Helper to disable a user if access expired
@@ -484,629 +633,733 @@ void DeactivateUser(uint8_t uIdx) {
     NVM_WriteAll();
 }
 
-// --- Main Application ---
+// --- States ---
+// Each state is a row of handlers in appStates[], looked up by its index:
+//   onEnter   once when the state is entered, after its touch settings
+//   onExit    once when it is left, before the next state's onEnter
+//   onEvent   a press, or a repeat of a held arrow
+//   onTick    every pass of the main loop, after onEvent
+//   onRender  every pass, last; full after entering and after UI_Invalidate()
+// State_Go() only names the next state, the switch happens between the
+// handlers, so a transition runs each hook exactly once. Going to the state
+// it is in leaves it and enters it again.
+typedef struct {
+    void (*onEnter)(void);
+    void (*onExit)(void);
+    void (*onEvent)(int8_t touch);
+    void (*onTick)(void);
+    void (*onRender)(bool full);
+    uint8_t profile;    // touch scan profile while in the state
+    bool fastRepeat;    // held arrows speed up, for editing values
+    uint16_t submitMs;  // pattern states: pause after the last node that submits
+    bool earlySubmit;   // ... or right away once the outcome is settled
+} StateDef;
+
+extern const StateDef appStates[STATE_COUNT];
+
+uint8_t nextState = STATE_BOOT;  // see State_Go()
+bool stateChange;
+bool needsRedraw;                // full repaint at the next onRender
+const uint8_t* menuItems;        // string ids of the fixed menu on screen
+uint8_t menuCount;               // rows of the menu on screen
+uint8_t patternShown;            // nodes of the pattern drawn so far
+uint8_t logShown;                // log entry the view on screen starts at
+#ifdef STATE_TIMING
+uint16_t stateWorstUs[STATE_COUNT];  // longest pass of each state, read it in the debugger
+#endif
+
+void State_Go(uint8_t next) {
+    nextState = next;
+    stateChange = true;
+}
 
-int main(void) {
-    INIT_CLOCK(); CTMUInit(); RGBMapColorPins(); RGBTurnOnLED(); ResetDevice(); RTCC_Init();
-    bool dataLoaded = NVM_ReadAll();
+// Back to the door: its menu, or with DOOR_IDENTIFY_USER the pattern grid
+void Door_Go(void) {
+    doorAnyUser = DOOR_IDENTIFY_USER;
+    menuIndex = 0;
+    State_Go(DOOR_IDENTIFY_USER ? STATE_VERIFY_DOOR : STATE_DOOR_OPEN_MENU);
+}
 
-    if (!dataLoaded || numUsers == 0) {
-        numUsers = 0; currentUser = 0; targetUserIdx = 0; 
-        PERMISSIONS[0] = 1; ACCESS_TYPE[0] = ACC_PERMANENT; USER_ACTIVE[0] = 1;
-        sysLanguage = 0; 
-        current_state = STATE_LANGUAGE_SELECT; 
-    } else {
-        currentUser = 0; 
-        current_state = STATE_SET_DATE; 
-        cursorIndex = 0;                
+void UI_Invalidate(void) {
+    needsRedraw = true;
+}
+
+// Up and down move the menu cursor, wrapping around. False for other pads.
+bool UI_MenuMove(int8_t touch) {
+    if (touch == 0) { if(menuIndex > 0) menuIndex--; else menuIndex = menuCount - 1; }
+    else if (touch == 2) { if(menuIndex < menuCount - 1) menuIndex++; else menuIndex = 0; }
+    else return false;
+    return true;
+}
+
+// Rows of a dynamic menu, built when it is entered
+void UI_MenuAdd(uint8_t str, int8_t action) {
+    sprintf(dynamicMenuLabels[menuCount], (char*)GetStr(str));
+    dynamicMenuMap[menuCount++] = action;
+}
+
+void UI_MenuRows(int y0) {
+    for(int i=0; i<menuCount; i++) UI_DrawString(10, y0 + (i * 9), dynamicMenuLabels[i]);
+}
+
+// -- Language --
+void LanguageRender(bool full) {
+    if (!full) return;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    UI_DrawString(20, 10, (char*)GetStr(S_LANG_SELECT));
+    GFX_DrawLine(0, 20, 127, 20);
+    UI_DrawString(20, 30, (sysLanguage==0) ? "> English" : "  English");
+    UI_DrawString(20, 45, (sysLanguage==1) ? "> Deutsch" : "  Deutsch");
+}
+
+void LanguageEvent(int8_t touch) {
+    if (touch == 0) sysLanguage = 0; else if (touch == 2) sysLanguage = 1;
+    else if (touch == 4) {
+        NVM_WriteAll();
+        // If reset/new, go to Welcome. Otherwise, go back to where we came from.
+        State_Go(numUsers == 0 ? STATE_WELCOME : returnState);
+        menuIndex = 0;
     }
-    
-    SetRGBs(0, 0, 255); 
-    bool needsRedraw = true; uint8_t state_last_loop = 255; 
+    UI_Invalidate();
+}
 
-    while(1) {
-        ReadCTMU(); 
-        if (current_state != state_last_loop) {
-            needsRedraw = true; state_last_loop = current_state;
-        }
-        int8_t rawInput = GetStableInput();
-        int8_t touch = -1;
-        if (rawInput == lastSeenButton && rawInput != -1) {
-            stableCount++;
-            if (stableCount >= DEBOUNCE_THRESH) {
-                touch = rawInput;
-                stableCount = DEBOUNCE_THRESH;
-            }
+// -- Welcome, date and time, tutorial --
+void WelcomeRender(bool full) {
+    if (full) DrawImage(0, 0, GetScreen(SCR_WELCOME));
+}
+
+void WelcomeEvent(int8_t touch) {
+    if (touch == 4) { State_Go(STATE_SET_DATE); cursorIndex = 0; }
+}
+
+void DateRender(bool full) {
+    if (!full) return;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(10, 10, (char*)GetStr(S_SET_DATE)); UI_DrawString(10, 30, "20"); UI_PrintNum(22, 30, editY, true); UI_DrawString(38, 30, "/"); UI_PrintNum(48, 30, editM, true); UI_DrawString(64, 30, "/"); UI_PrintNum(74, 30, editD, true);
+    int cursX = (cursorIndex == 0) ? 22 : (cursorIndex == 1) ? 48 : 74; GFX_DrawLine(cursX, 39, cursX+10, 39);
+}
+
+void DateEvent(int8_t touch) {
+    if (touch == 1) { if(cursorIndex < 2) cursorIndex++; } else if (touch == 3) { if(cursorIndex > 0) cursorIndex--; }
+    else if (touch == 0) { if(cursorIndex == 0 && editY < 99) editY++; if(cursorIndex == 1 && editM < 12) editM++; if(cursorIndex == 2 && editD < 31) editD++; }
+    else if (touch == 2) { if(cursorIndex == 0 && editY > 20) editY--; if(cursorIndex == 1 && editM > 1) editM--; if(cursorIndex == 2 && editD > 1) editD--; }
+    else if (touch == 4) { State_Go(STATE_SET_TIME); cursorIndex = 0; }
+    UI_Invalidate();
+}
+
+void TimeRender(bool full) {
+    if (!full) return;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(10, 10, (char*)GetStr(S_SET_TIME)); UI_PrintNum(30, 30, editH, true); UI_DrawString(46, 30, ":"); UI_PrintNum(56, 30, editMin, true);
+    int cursX = (cursorIndex == 0) ? 30 : 56; GFX_DrawLine(cursX, 39, cursX+10, 39);
+}
+
+void TimeEvent(int8_t touch) {
+    if (touch == 1 || touch == 3) { cursorIndex = !cursorIndex; } else if (touch == 0) { if(cursorIndex == 0 && editH < 23) editH++; if(cursorIndex == 1 && editMin < 59) editMin++; }
+    else if (touch == 2) { if(cursorIndex == 0 && editH > 0) editH--; if(cursorIndex == 1 && editMin > 0) editMin--; }
+    else if (touch == 4) {
+        RTCC_Set(editY, editM, editD, editH, editMin);
+
+        if (numUsers > 0) {
+            Door_Go();
         } else {
-            stableCount = 0;
-            lastSeenButton = rawInput;
+            State_Go(STATE_TUTORIAL);
+            targetUserIdx = 0;
         }
+    }
+    UI_Invalidate();
+}
 
-        // --- STATE MACHINE ---
-        
-        if (current_state == STATE_LANGUAGE_SELECT) {
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE);
-                UI_DrawString(20, 10, (char*)GetStr(S_LANG_SELECT)); 
-                GFX_DrawLine(0, 20, 127, 20);
-                UI_DrawString(20, 30, (sysLanguage==0) ? "> English" : "  English");
-                UI_DrawString(20, 45, (sysLanguage==1) ? "> Deutsch" : "  Deutsch");
-                needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 0) sysLanguage = 0; else if (touch == 2) sysLanguage = 1; 
-                else if (touch == 4) { 
-                    NVM_WriteAll(); 
-                    // If reset/new, go to Welcome. Otherwise, go back to where we came from.
-                    if (numUsers == 0) current_state = STATE_WELCOME; 
-                    else current_state = returnState;
-                    menuIndex = 0;
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
-        }
-        else if (current_state == STATE_WELCOME) {
-             if (needsRedraw) { SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(40, 25, (char*)GetStr(S_WELCOME)); UI_DrawString(10, 40, (char*)GetStr(S_PRESS_CENTER)); needsRedraw = false; }
-             if(buttons[4]) { delay(5000); current_state = STATE_SET_DATE; cursorIndex = 0; while(buttons[4]) ReadCTMU(); }
-        }
-        else if (current_state == STATE_SET_DATE) {
-             if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(10, 10, (char*)GetStr(S_SET_DATE)); UI_DrawString(10, 30, "20"); UI_PrintNum(22, 30, editY, true); UI_DrawString(38, 30, "/"); UI_PrintNum(48, 30, editM, true); UI_DrawString(64, 30, "/"); UI_PrintNum(74, 30, editD, true);
-                int cursX = (cursorIndex == 0) ? 22 : (cursorIndex == 1) ? 48 : 74; GFX_DrawLine(cursX, 39, cursX+10, 39); needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 1) { if(cursorIndex < 2) cursorIndex++; } else if (touch == 3) { if(cursorIndex > 0) cursorIndex--; }
-                else if (touch == 0) { if(cursorIndex == 0 && editY < 99) editY++; if(cursorIndex == 1 && editM < 12) editM++; if(cursorIndex == 2 && editD < 31) editD++; } 
-                else if (touch == 2) { if(cursorIndex == 0 && editY > 20) editY--; if(cursorIndex == 1 && editM > 1) editM--; if(cursorIndex == 2 && editD > 1) editD--; } 
-                else if (touch == 4) { current_state = STATE_SET_TIME; cursorIndex = 0; while(buttons[4]) ReadCTMU(); }
-                needsRedraw = true; delay(5000); 
-            } else delay(1000); 
-        }
-        else if (current_state == STATE_SET_TIME) {
-             if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(10, 10, (char*)GetStr(S_SET_TIME)); UI_PrintNum(30, 30, editH, true); UI_DrawString(46, 30, ":"); UI_PrintNum(56, 30, editMin, true);
-                int cursX = (cursorIndex == 0) ? 30 : 56; GFX_DrawLine(cursX, 39, cursX+10, 39); needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 1 || touch == 3) { cursorIndex = !cursorIndex; } else if (touch == 0) { if(cursorIndex == 0 && editH < 23) editH++; if(cursorIndex == 1 && editMin < 59) editMin++; } 
-                else if (touch == 2) { if(cursorIndex == 0 && editH > 0) editH--; if(cursorIndex == 1 && editMin > 0) editMin--; } 
-                else if (touch == 4) { 
-                    RTCC_Set(editY, editM, editD, editH, editMin); 
-                    
-                    if (numUsers > 0) {
-                        current_state = STATE_DOOR_OPEN_MENU;
-                        menuIndex = 0;
-                    } else {
-                        current_state = STATE_TUTORIAL; 
-                        targetUserIdx = 0; 
-                    }
-                    
-                    while(buttons[4]) ReadCTMU(); 
-                }
-                needsRedraw = true; delay(5000);
-            } else delay(1000);
+void TutorialRender(bool full) {
+    if (full) DrawImage(0, 0, GetScreen(SCR_TUTORIAL));
+}
+
+void TutorialEvent(int8_t touch) {
+    if (touch == 4) { State_Go(STATE_SET_PATTERN); passTaken = 0; }
+}
+
+// -- Main menu --
+void MenuEnter(void) {
+    if (currentUser == 0) { menuCount = MENU_COUNT_ADMIN; menuItems = menuItemsAdmin; }
+    else { if (PERMISSIONS[currentUser]) { menuCount = MENU_COUNT_USER_FULL; menuItems = menuItemsUserFull; } else { menuCount = MENU_COUNT_USER_RESTRICTED; menuItems = menuItemsUserRestricted; } }
+}
+
+void MenuRender(bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        UI_DrawString(35, 2, (char*)((currentUser==0)?GetStr(S_MENU_ADMIN):GetStr(S_MENU_USER)));
+
+        // Show Remaining Accesses (Bottom Right)
+        if (currentUser != 0) {
+             DrawImage(24, 1, IMG_USER);
+             char buf[12];
+             if (ACCESS_TYPE[currentUser] == ACC_ONETIME) {
+                 sprintf(buf, "%s 1", (char*)GetStr(S_REMAINING));
+                 UI_DrawString(70, 55, buf);
+             } else if (ACCESS_TYPE[currentUser] == ACC_MULTI) {
+                 sprintf(buf, "%s %d", (char*)GetStr(S_REMAINING), ACCESS_COUNT[currentUser]);
+                 UI_DrawString(70, 55, buf);
+             }
         }
-        else if (current_state == STATE_TUTORIAL) {
-             if (needsRedraw) { SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(5, 5, (char*)GetStr(S_TUTORIAL_TITLE)); GFX_DrawLine(0, 15, 127, 15); UI_DrawString(5, 25, (char*)GetStr(S_TUT_1)); UI_DrawString(5, 35, (char*)GetStr(S_TUT_2)); UI_DrawString(5, 45, (char*)GetStr(S_TUT_3)); UI_DrawString(5, 55, (char*)GetStr(S_PRESS_CENTER)); needsRedraw = false; }
-            if(buttons[4]) { delay(5000); UI_ResetGrid(); current_state = STATE_SET_PATTERN; SetRGBs(100, 0, 100); while(buttons[4]) ReadCTMU(); }
+
+        GFX_DrawLine(0, 9, 127, 9);
+        for(int i=0; i<menuCount; i++) { int yPos = 12 + (i * 9); UI_DrawString(10, yPos, (char*)GetStr(menuItems[i])); }
+        UI_MenuBegin(); SetRGBs(0, 0, 255);
+    }
+    UI_MenuCursor(12 + (menuIndex * 9));
+}
+
+void MenuEvent(int8_t touch) {
+    if (touch != 4) { UI_MenuMove(touch); return; }
+    uint8_t action = menuItems[menuIndex];
+    if (action == S_M_CHANGE_PASS) { State_Go(STATE_SET_PATTERN); targetUserIdx = (currentUser==0)?0:currentUser; passTaken = 0; }
+    else if (action == S_M_CREATE_USER) {
+        if (numUsers >= MAX_USERS) State_Go(STATE_ERROR_MSG);
+        else {
+            // Default for new user
+            cfgActive = 1;
+            cfgPerm = 0; cfgAccType = ACC_ONETIME; cfgAccCount = 5;
+            cfgIsNewUser = true; targetUserIdx = numUsers;
+            State_Go(STATE_USER_CONFIG); cursorIndex = 0;
         }
+    }
+    else if (action == S_M_ADVANCED) { State_Go(STATE_ADVANCED_MENU); menuIndex = 0; }
+    else if (action == S_M_LANG) {
+        returnState = STATE_MENU; // <--- Tell it to come back to the Admin/User menu
+        State_Go(STATE_LANGUAGE_SELECT);
+    }
+    else if (action == S_M_EXIT) Door_Go();
+    else if (action == S_M_LOGIN_SESSIONS) { State_Go(STATE_USER_LOGS); userLogScroll = 0; }
+}
 
-        // --- MAIN MENU ---
-        else if (current_state == STATE_MENU) {
-            int count; const uint8_t* items;
-            if (currentUser == 0) { count = MENU_COUNT_ADMIN; items = menuItemsAdmin; } 
-            else { if (PERMISSIONS[currentUser]) { count = MENU_COUNT_USER_FULL; items = menuItemsUserFull; } else { count = MENU_COUNT_USER_RESTRICTED; items = menuItemsUserRestricted; } }
-
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); 
-                UI_DrawString(35, 2, (char*)((currentUser==0)?GetStr(S_MENU_ADMIN):GetStr(S_MENU_USER))); 
-                
-                // Show Remaining Accesses (Bottom Right)
-                if (currentUser != 0) {
-                     char buf[12];
-                     if (ACCESS_TYPE[currentUser] == ACC_ONETIME) {
-                         sprintf(buf, "%s 1", (char*)GetStr(S_REMAINING));
-                         UI_DrawString(70, 55, buf);
-                     } else if (ACCESS_TYPE[currentUser] == ACC_MULTI) {
-                         sprintf(buf, "%s %d", (char*)GetStr(S_REMAINING), ACCESS_COUNT[currentUser]);
-                         UI_DrawString(70, 55, buf);
-                     }
-                }
-                
-                GFX_DrawLine(0, 9, 127, 9);
-                for(int i=0; i<count; i++) { int yPos = 12 + (i * 9); if(i == menuIndex) UI_DrawString(2, yPos, ">"); UI_DrawString(10, yPos, (char*)GetStr(items[i])); }
-                SetRGBs(0, 0, 255); needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 0) { if(menuIndex > 0) menuIndex--; else menuIndex = count - 1; } 
-                else if (touch == 2) { if(menuIndex < count - 1) menuIndex++; else menuIndex = 0; } 
-                else if (touch == 4) { 
-                    uint8_t action = items[menuIndex];
-                    if (action == S_M_CHANGE_PASS) { UI_ResetGrid(); current_state = STATE_SET_PATTERN; targetUserIdx = (currentUser==0)?0:currentUser; SetRGBs(100, 0, 100); }
-                    else if (action == S_M_CREATE_USER) { 
-                        if (numUsers >= MAX_USERS) current_state = STATE_ERROR_MSG; 
-                        else { 
-                            // Default for new user
-                            cfgActive = 1;
-                            cfgPerm = 0; cfgAccType = ACC_ONETIME; cfgAccCount = 5; 
-                            cfgIsNewUser = true; targetUserIdx = numUsers;
-                            current_state = STATE_USER_CONFIG; cursorIndex = 0; 
-                        } 
-                    }
-                    else if (action == S_M_ADVANCED) { current_state = STATE_ADVANCED_MENU; menuIndex = 0; }
-                    else if (action == S_M_LANG) { 
-                        returnState = STATE_MENU; // <--- Tell it to come back to the Admin/User menu
-                        current_state = STATE_LANGUAGE_SELECT; 
-                    }
-                    else if (action == S_M_EXIT) { current_state = STATE_DOOR_OPEN_MENU; menuIndex = 0; }
-                    else if (action == S_M_LOGIN_SESSIONS) { current_state = STATE_USER_LOGS; userLogScroll = 0; }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
+// -- Advanced menu --
+void AdvancedEnter(void) {
+    menuCount = 0;
+    UI_MenuAdd(S_M_PERMS, 1);
+    UI_MenuAdd(S_M_LOGS, 2);
+    if (numUsers > 1) UI_MenuAdd(S_M_LOGIN_U1, 3);  // Login User 1 (Only if created)
+    if (numUsers > 2) UI_MenuAdd(S_M_LOGIN_U2, 4);  // Login User 2 (Only if created)
+    UI_MenuAdd(S_BACK, 99);
+}
+
+void AdvancedRender(bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        UI_DrawString(30, 2, (char*)GetStr(S_M_ADVANCED)); GFX_DrawLine(0, 9, 127, 9);
+        UI_MenuRows(12);
+        UI_MenuBegin();
+    }
+    UI_MenuCursor(12 + (menuIndex * 9));
+}
+
+void AdvancedEvent(int8_t touch) {
+    if (touch != 4) { UI_MenuMove(touch); return; }
+    uint8_t action = dynamicMenuMap[menuIndex];
+    if (action == 1) { State_Go(STATE_PERMISSIONS); cursorIndex = 0; }
+    else if (action == 2) { State_Go(STATE_ADMIN_LOGS); logScroll = 0; }
+    else if (action == 3 || action == 4) {
+        // Login to User 1 or 2
+        currentUser = action - 2;
+        State_Go(STATE_MENU);
+        menuIndex = 0;
+        Log_Add(currentUser, LOG_TYPE_SETTINGS, LOG_STATUS_SUCCESS); // Log successful login
+    }
+    else if (action == 99) { State_Go(STATE_MENU); menuIndex = 0; }
+}
+
+// -- Permissions list and user configuration --
+void PermissionsRender(bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(30, 5, (char*)GetStr(S_M_PERMS)); GFX_DrawLine(0, 15, 127, 15);
+        if (numUsers <= 1) UI_DrawString(10, 30, (char*)GetStr(S_MSG_NO_USERS));
+        else {
+            for(int i=1; i<numUsers; i++) {
+                int y = 25 + ((i-1)*15); char buf[15]; sprintf(buf, "User %d", i); UI_DrawString(20, y, buf);
+                // Show Active Status
+                UI_DrawString(80, y, USER_ACTIVE[i] ? "[x]" : "[ ]");
             }
         }
-        
-        // --- ADVANCED MENU ---
-        else if (current_state == STATE_ADVANCED_MENU) {
-            // Build Dynamic Menu for Advanced options
-            int idx = 0;
-            
-            // Permissions
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_M_PERMS)); 
-            dynamicMenuMap[idx] = 1; 
-            idx++;
-            
-            // Admin Logs
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_M_LOGS)); 
-            dynamicMenuMap[idx] = 2; 
-            idx++;
-            
-            // Login User 1 (Only if created)
-            if (numUsers > 1) {
-                sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_M_LOGIN_U1)); 
-                dynamicMenuMap[idx] = 3; 
-                idx++;
-            }
-            
-            // Login User 2 (Only if created)
-            if (numUsers > 2) {
-                sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_M_LOGIN_U2)); 
-                dynamicMenuMap[idx] = 4; 
-                idx++;
-            }
-            
-            // Back
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_BACK)); 
-            dynamicMenuMap[idx] = 99; 
-            idx++;
-            
-            int count = idx;
-            
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); 
-                UI_DrawString(30, 2, (char*)GetStr(S_M_ADVANCED)); GFX_DrawLine(0, 9, 127, 9);
-                for(int i=0; i<count; i++) { 
-                    int yPos = 12 + (i * 9); 
-                    if(i == menuIndex) UI_DrawString(2, yPos, ">"); 
-                    UI_DrawString(10, yPos, dynamicMenuLabels[i]); 
-                }
-                needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 0) { if(menuIndex > 0) menuIndex--; else menuIndex = count - 1; } 
-                else if (touch == 2) { if(menuIndex < count - 1) menuIndex++; else menuIndex = 0; } 
-                else if (touch == 4) {
-                    uint8_t action = dynamicMenuMap[menuIndex];
-                    if (action == 1) { current_state = STATE_PERMISSIONS; cursorIndex = 0; }
-                    else if (action == 2) { current_state = STATE_ADMIN_LOGS; logScroll = 0; }
-                    else if (action == 3) { 
-                        // Login to User 1
-                        currentUser = 1; 
-                        current_state = STATE_MENU; 
-                        menuIndex = 0; 
-                        Log_Add(1, LOG_TYPE_SETTINGS, LOG_STATUS_SUCCESS); // Log successful login
-                    }
-                    else if (action == 4) { 
-                        // Login to User 2
-                        currentUser = 2; 
-                        current_state = STATE_MENU; 
-                        menuIndex = 0; 
-                        Log_Add(2, LOG_TYPE_SETTINGS, LOG_STATUS_SUCCESS); // Log successful login
-                    }
-                    else if (action == 99) { current_state = STATE_MENU; menuIndex = 0; }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+        UI_DrawString(5, 55, (char*)GetStr(S_BACK)); UI_MenuBegin();
+    }
+    UI_MenuCursor((numUsers > 1) ? 25 + (cursorIndex * 15) : -1);
+}
+
+void PermissionsEvent(int8_t touch) {
+    int maxCursor = (numUsers > 1) ? (numUsers - 2) : 0;
+    if (touch == 3) { State_Go(STATE_ADVANCED_MENU); menuIndex = 0; }
+    else if (numUsers > 1) {
+        if (touch == 0) { if(cursorIndex > 0) cursorIndex--; }
+        else if (touch == 2) { if(cursorIndex < maxCursor) cursorIndex++; }
+        else if (touch == 4) {
+            targetUserIdx = cursorIndex + 1;
+            cfgActive = USER_ACTIVE[targetUserIdx];
+            cfgPerm = PERMISSIONS[targetUserIdx];
+            cfgAccType = ACCESS_TYPE[targetUserIdx];
+            cfgAccCount = ACCESS_COUNT[targetUserIdx];
+            if (cfgAccCount < 2) cfgAccCount = 2; // enforce min
+            cfgIsNewUser = false;
+            State_Go(STATE_USER_CONFIG);
+            cursorIndex = 0;
         }
+    }
+}
 
-        // --- PERMISSIONS LIST ---
-        else if (current_state == STATE_PERMISSIONS) {
-             if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(30, 5, (char*)GetStr(S_M_PERMS)); GFX_DrawLine(0, 15, 127, 15);
-                if (numUsers <= 1) UI_DrawString(10, 30, (char*)GetStr(S_MSG_NO_USERS));
-                else {
-                    for(int i=1; i<numUsers; i++) { 
-                        int y = 25 + ((i-1)*15); char buf[15]; sprintf(buf, "User %d", i); UI_DrawString(20, y, buf);
-                        // Show Active Status
-                        UI_DrawString(80, y, USER_ACTIVE[i] ? "[x]" : "[ ]");
-                        if (cursorIndex == (i-1)) UI_DrawString(10, y, ">");
-                    }
-                }
-                UI_DrawString(5, 55, (char*)GetStr(S_BACK)); needsRedraw = false;
-            }
-            if (touch != -1) {
-                int maxCursor = (numUsers > 1) ? (numUsers - 2) : 0;
-                if (touch == 3) { current_state = STATE_ADVANCED_MENU; menuIndex = 0; } 
-                else if (numUsers > 1) {
-                    if (touch == 0) { if(cursorIndex > 0) cursorIndex--; } 
-                    else if (touch == 2) { if(cursorIndex < maxCursor) cursorIndex++; } 
-                    else if (touch == 4) { 
-                        targetUserIdx = cursorIndex + 1;
-                        cfgActive = USER_ACTIVE[targetUserIdx];
-                        cfgPerm = PERMISSIONS[targetUserIdx];
-                        cfgAccType = ACCESS_TYPE[targetUserIdx];
-                        cfgAccCount = ACCESS_COUNT[targetUserIdx];
-                        if (cfgAccCount < 2) cfgAccCount = 2; // enforce min
-                        cfgIsNewUser = false;
-                        current_state = STATE_USER_CONFIG; 
-                        cursorIndex = 0;
-                    }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
+void ConfigRender(bool full) {
+    // Rows 2 & 3 appear or vanish with these, that needs a full repaint
+    if (cfgActive != cfgShownActive || (cfgAccType == ACC_MULTI) != (cfgShownAccType == ACC_MULTI))
+        full = true;
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        UI_DrawString(30, 2, (char*)GetStr(S_CONF_TITLE));
+
+        // Row 0: Active
+        UI_DrawString(10, 12, (char*)GetStr(S_LBL_ACTIVE));
+        UI_DrawString(50, 12, cfgActive ? "[x]" : "[ ]");
+
+        // Row 1: Chg PW
+        UI_DrawString(10, 22, (char*)GetStr(S_LBL_CHG_PW));
+        UI_DrawString(50, 22, cfgPerm ? "[x]" : "[ ]");
+
+        // Rows 2 & 3: Only if Active
+        if (cfgActive) {
+            // Row 2: Access Type
+            UI_DrawString(10, 32, (char*)GetStr(S_ACC_TYPE));
+            if (cfgAccType == ACC_PERMANENT) UI_DrawString(50, 32, (char*)GetStr(S_ACC_PERM));
+            else if (cfgAccType == ACC_ONETIME) UI_DrawString(50, 32, (char*)GetStr(S_ACC_ONCE));
+            else UI_DrawString(50, 32, (char*)GetStr(S_ACC_MULTI));
+
+            // Row 3: Count
+            if (cfgAccType == ACC_MULTI) {
+                UI_DrawString(10, 42, (char*)GetStr(S_LBL_COUNT));
+                UI_PrintNum(50, 42, cfgAccCount, false);
             }
         }
 
-        // --- USER CONFIGURATION ---
-        else if (current_state == STATE_USER_CONFIG) {
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE);
-                UI_DrawString(30, 2, (char*)GetStr(S_CONF_TITLE));
-                
-                // Row 0: Active
-                UI_DrawString(10, 12, (char*)GetStr(S_LBL_ACTIVE));
-                if (cursorIndex==0) UI_DrawString(2, 12, ">");
-                UI_DrawString(50, 12, cfgActive ? "[x]" : "[ ]");
-
-                // Row 1: Chg PW
-                UI_DrawString(10, 22, (char*)GetStr(S_LBL_CHG_PW));
-                if (cursorIndex==1) UI_DrawString(2, 22, ">");
-                UI_DrawString(50, 22, cfgPerm ? "[x]" : "[ ]");
-
-                // Rows 2 & 3: Only if Active
-                if (cfgActive) {
-                    // Row 2: Access Type
-                    UI_DrawString(10, 32, (char*)GetStr(S_ACC_TYPE));
-                    if (cursorIndex==2) UI_DrawString(2, 32, ">");
-                    if (cfgAccType == ACC_PERMANENT) UI_DrawString(50, 32, (char*)GetStr(S_ACC_PERM));
-                    else if (cfgAccType == ACC_ONETIME) UI_DrawString(50, 32, (char*)GetStr(S_ACC_ONCE));
-                    else UI_DrawString(50, 32, (char*)GetStr(S_ACC_MULTI));
-
-                    // Row 3: Count
-                    if (cfgAccType == ACC_MULTI) {
-                        UI_DrawString(10, 42, (char*)GetStr(S_LBL_COUNT));
-                        if (cursorIndex==3) UI_DrawString(2, 42, ">");
-                        UI_PrintNum(50, 42, cfgAccCount, false);
-                    }
-                }
-
-                // Row 4: Action
-                int yAct = 55;
-                if (cursorIndex==4) UI_DrawString(2, yAct, ">");
-                UI_DrawString(10, yAct, cfgIsNewUser ? (char*)GetStr(S_NEXT) : (char*)GetStr(S_SAVE));
-
-                needsRedraw = false;
-            }
+        // Row 4: Action
+        int yAct = 55;
+        UI_DrawString(10, yAct, cfgIsNewUser ? (char*)GetStr(S_NEXT) : (char*)GetStr(S_SAVE));
+
+        cfgShownActive = cfgActive; cfgShownPerm = cfgPerm;
+        cfgShownAccType = cfgAccType; cfgShownAccCount = cfgAccCount;
+        UI_MenuBegin();
+    } else if (cfgPerm != cfgShownPerm || cfgAccType != cfgShownAccType || cfgAccCount != cfgShownAccCount) {
+        // Same layout: overwrite only the value fields that changed
+        uiOpaqueText = true;
+        if (cfgPerm != cfgShownPerm) {
+            UI_DrawString(50, 22, cfgPerm ? "[x]" : "[ ]");
+            cfgShownPerm = cfgPerm;
+        }
+        if (cfgAccType != cfgShownAccType) {
+            char buf[32];
+            uint8_t id = (cfgAccType == ACC_PERMANENT) ? S_ACC_PERM : (cfgAccType == ACC_ONETIME) ? S_ACC_ONCE : S_ACC_MULTI;
+            sprintf(buf, "%-12s", (char*)GetStr(id));  // pad over the old label
+            buf[12] = 0;                                // up to the right edge
+            UI_DrawString(50, 32, buf);
+            cfgShownAccType = cfgAccType;
+        }
+        if (cfgAccCount != cfgShownAccCount) {
+            char buf[5];
+            sprintf(buf, "%-3d", cfgAccCount);
+            UI_DrawString(50, 42, buf);
+            cfgShownAccCount = cfgAccCount;
+        }
+        uiOpaqueText = false;
+    }
+    UI_MenuCursor(cfgRowY[cursorIndex]);
+}
 
-            if (touch != -1) {
-                // Nav Up
-                if (touch == 0) { 
-                    if (cursorIndex > 0) cursorIndex--;
-                    // If moving up from 4
-                    if (cursorIndex == 3) {
-                        if (!cfgActive) cursorIndex = 1; // Skip both if inactive
-                        else if (cfgAccType != ACC_MULTI) cursorIndex = 2; // Skip count
-                    }
-                    else if (cursorIndex == 2 && !cfgActive) cursorIndex = 1; // Safety fallback
-                }
-                // Nav Down
-                else if (touch == 2) { 
-                    if (cursorIndex < 4) cursorIndex++;
-                    // If moving down from 1
-                    if (cursorIndex == 2) {
-                        if (!cfgActive) cursorIndex = 4; // Skip to action
-                    }
-                    else if (cursorIndex == 3 && cfgAccType != ACC_MULTI) cursorIndex = 4; // Skip count
-                }
-                // Toggle/Change
-                else if (touch == 1 || touch == 3) {
-                    if (cursorIndex == 0) { 
-                        cfgActive = !cfgActive; 
-                        // Default to 1-Time on Enable
-                        if (cfgActive) cfgAccType = ACC_ONETIME; 
-                    }
-                    else if (cursorIndex == 1) cfgPerm = !cfgPerm; 
-                    else if (cursorIndex == 2 && cfgActive) {
-                        if (touch==3) { if(cfgAccType < 2) cfgAccType++; else cfgAccType=0; }
-                        else { if(cfgAccType > 0) cfgAccType--; else cfgAccType=2; }
-                    }
-                    else if (cursorIndex == 3 && cfgActive && cfgAccType == ACC_MULTI) { 
-                        // Min value 2
-                        if (touch==1 && cfgAccCount < 250) cfgAccCount++;
-                        else if (touch==3 && cfgAccCount > 2) cfgAccCount--;
-                    }
-                }
-                // Select
-                else if (touch == 4) {
-                    if (cursorIndex == 4) { 
-                        if (cfgIsNewUser) {
-                             current_state = STATE_TUTORIAL; 
-                        } else {
-                             USER_ACTIVE[targetUserIdx] = cfgActive;
-                             PERMISSIONS[targetUserIdx] = cfgPerm;
-                             ACCESS_TYPE[targetUserIdx] = cfgAccType;
-                             ACCESS_COUNT[targetUserIdx] = cfgAccCount;
-                             NVM_WriteAll();
-                             current_state = STATE_PERMISSIONS; 
-                             cursorIndex = targetUserIdx - 1;
-                        }
-                    }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+void ConfigEvent(int8_t touch) {
+    // Nav Up
+    if (touch == 0) {
+        if (cursorIndex > 0) cursorIndex--;
+        // If moving up from 4
+        if (cursorIndex == 3) {
+            if (!cfgActive) cursorIndex = 1; // Skip both if inactive
+            else if (cfgAccType != ACC_MULTI) cursorIndex = 2; // Skip count
         }
-        
-        else if (current_state == STATE_ADMIN_LOGS) {
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE);
-                UI_DrawString(30, 5, (char*)GetStr(S_LOGS_TITLE)); GFX_DrawLine(0, 15, 127, 15);
-                if (logCount == 0) UI_DrawString(10, 30, (char*)GetStr(S_LOGS_NONE));
-                else {
-                    for(int i=0; i<3; i++) { 
-                        int idx = logScroll + i;
-                        if (idx >= logCount) break;
-                        int y = 25 + (i*10);
-                        LogEntry l = ADMIN_LOGS[idx];
-                        char buf[25]; char uStr[3] = "Ad";
-                        if (l.userIdx == 1) sprintf(uStr, "G1"); if (l.userIdx == 2) sprintf(uStr, "G2");
-                        char tStr[3] = "St"; if (l.type == LOG_TYPE_DOOR) sprintf(tStr, "Dr");
-                        char sStr[3] = "XX"; if (l.status == LOG_STATUS_SUCCESS) sprintf(sStr, "OK");
-                        sprintf(buf, "%s %02d/%02d %02d:%02d %s %s", uStr, l.mon, l.day, l.hour, l.min, tStr, sStr);
-                        UI_DrawString(2, y, buf);
-                    }
-                }
-                UI_DrawString(5, 55, (char*)GetStr(S_BACK)); needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 3) { current_state = STATE_ADVANCED_MENU; menuIndex = 0; } 
-                else if (touch == 2) { if (logScroll < logCount - 1) logScroll++; } 
-                else if (touch == 0) { if (logScroll > 0) logScroll--; } 
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+        else if (cursorIndex == 2 && !cfgActive) cursorIndex = 1; // Safety fallback
+    }
+    // Nav Down
+    else if (touch == 2) {
+        if (cursorIndex < 4) cursorIndex++;
+        // If moving down from 1
+        if (cursorIndex == 2) {
+            if (!cfgActive) cursorIndex = 4; // Skip to action
         }
-        else if (current_state == STATE_USER_LOGS) {
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE);
-                UI_DrawString(20, 5, (char*)GetStr(S_M_LOGIN_SESSIONS)); GFX_DrawLine(0, 15, 127, 15);
-                int totalUserLogs = 0;
-                for(int k=0; k<logCount; k++) { if (ADMIN_LOGS[k].userIdx == currentUser) totalUserLogs++; }
-                if (totalUserLogs == 0) UI_DrawString(10, 30, (char*)GetStr(S_LOGS_NONE));
-                else {
-                    int foundCount = 0; int displayed = 0;
-                    for(int k=0; k<logCount; k++) {
-                        if (ADMIN_LOGS[k].userIdx == currentUser) {
-                            if (foundCount >= userLogScroll && displayed < 3) {
-                                int y = 25 + (displayed*10);
-                                LogEntry l = ADMIN_LOGS[k];
-                                char buf[25];
-                                char tStr[3] = "St"; if (l.type == LOG_TYPE_DOOR) sprintf(tStr, "Dr");
-                                char sStr[3] = "XX"; if (l.status == LOG_STATUS_SUCCESS) sprintf(sStr, "OK");
-                                sprintf(buf, "%02d/%02d %02d:%02d %s %s", l.mon, l.day, l.hour, l.min, tStr, sStr);
-                                UI_DrawString(2, y, buf);
-                                displayed++;
-                            }
-                            foundCount++;
-                        }
-                    }
-                }
-                UI_DrawString(5, 55, (char*)GetStr(S_BACK)); needsRedraw = false;
-            }
-            if (touch != -1) {
-                int totalUserLogs = 0;
-                for(int k=0; k<logCount; k++) { if (ADMIN_LOGS[k].userIdx == currentUser) totalUserLogs++; }
-                if (touch == 3) { current_state = STATE_MENU; menuIndex = 0; } 
-                else if (touch == 2) { if (totalUserLogs > 0 && userLogScroll < totalUserLogs - 1) userLogScroll++; } 
-                else if (touch == 0) { if (userLogScroll > 0) userLogScroll--; } 
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+        else if (cursorIndex == 3 && cfgAccType != ACC_MULTI) cursorIndex = 4; // Skip count
+    }
+    // Toggle/Change
+    else if (touch == 1 || touch == 3) {
+        if (cursorIndex == 0) {
+            cfgActive = !cfgActive;
+            // Default to 1-Time on Enable
+            if (cfgActive) cfgAccType = ACC_ONETIME;
         }
-        else if (current_state == STATE_DOOR_OPEN_MENU) {
-            int idx = 0;
-            if (numUsers > 1 && PASS_LENS[1] > 0 && USER_ACTIVE[1]) { sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_OPEN_AS_G1)); dynamicMenuMap[idx] = 1; idx++; }
-            if (numUsers > 2 && PASS_LENS[2] > 0 && USER_ACTIVE[2]) { sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_OPEN_AS_G2)); dynamicMenuMap[idx] = 2; idx++; }
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_OPEN_AS_ADMIN)); dynamicMenuMap[idx] = 0; idx++;
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_SETTINGS)); dynamicMenuMap[idx] = -1; idx++;
-            int count = idx;
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(30, 5, (char*)GetStr(S_DOOR_MENU)); GFX_DrawLine(0, 15, 127, 15);
-                for(int i=0; i<count; i++) { int yPos = 20 + (i * 9); if(i == menuIndex) UI_DrawString(2, yPos, ">"); UI_DrawString(10, yPos, dynamicMenuLabels[i]); }
-                SetRGBs(0, 0, 255); needsRedraw = false;
-            }
-            if (touch != -1) {
-                if (touch == 0) { if(menuIndex > 0) menuIndex--; else menuIndex = count - 1; }
-                else if (touch == 2) { if(menuIndex < count - 1) menuIndex++; else menuIndex = 0; }
-                else if (touch == 4) { 
-                    int action = dynamicMenuMap[menuIndex];
-                    if (action == -1) { current_state = STATE_LOGIN_SETTINGS; menuIndex = 0; } 
-                    else { targetUserIdx = action; UI_ResetGrid(); current_state = STATE_VERIFY_DOOR; }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+        else if (cursorIndex == 1) cfgPerm = !cfgPerm;
+        else if (cursorIndex == 2 && cfgActive) {
+            if (touch==3) { if(cfgAccType < 2) cfgAccType++; else cfgAccType=0; }
+            else { if(cfgAccType > 0) cfgAccType--; else cfgAccType=2; }
         }
-        else if (current_state == STATE_LOGIN_SETTINGS) {
-            int idx = 0;
-            // User 1 (if active)
-            if (numUsers > 1 && PASS_LENS[1] > 0 && USER_ACTIVE[1]) { 
-                sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_LOGIN_AS_G1)); 
-                dynamicMenuMap[idx] = 1; 
-                idx++; 
-            }
-            // User 2 (if active)
-            if (numUsers > 2 && PASS_LENS[2] > 0 && USER_ACTIVE[2]) { 
-                sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_LOGIN_AS_G2)); 
-                dynamicMenuMap[idx] = 2; 
-                idx++; 
-            }
-            
-            // Admin
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_LOGIN_AS_ADMIN)); 
-            dynamicMenuMap[idx] = 0; 
-            idx++;
-            
-            // Language Option (ID 50)
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_M_LANG)); 
-            dynamicMenuMap[idx] = 50; 
-            idx++;
-
-            // Back Option
-            sprintf(dynamicMenuLabels[idx], (char*)GetStr(S_BACK)); 
-            dynamicMenuMap[idx] = -1; 
-            idx++;
-            
-            int count = idx;
-            
-            if (needsRedraw) {
-                SetColor(BLACK); ClearDevice(); SetColor(WHITE); 
-                UI_DrawString(20, 5, (char*)GetStr(S_LOGIN_SETTINGS)); 
-                GFX_DrawLine(0, 15, 127, 15);
-                
-                for(int i=0; i<count; i++) { 
-                    int yPos = 20 + (i * 9); 
-                    if(i == menuIndex) UI_DrawString(2, yPos, ">"); 
-                    UI_DrawString(10, yPos, dynamicMenuLabels[i]); 
-                }
-                
-                SetRGBs(0, 0, 255); // Reset to Blue
-                needsRedraw = false;
-            }
-            
-            if (touch != -1) {
-                // Scroll Up
-                if (touch == 0) { 
-                    if(menuIndex > 0) menuIndex--; else menuIndex = count - 1; 
-                }
-                // Scroll Down
-                else if (touch == 2) { 
-                    if(menuIndex < count - 1) menuIndex++; else menuIndex = 0; 
-                }
-                // Select
-                else if (touch == 4) { 
-                    int action = dynamicMenuMap[menuIndex];
-                    
-                    if (action == -1) { 
-                        // Back
-                        current_state = STATE_DOOR_OPEN_MENU; 
-                        menuIndex = 0; 
-                    } 
-                    else if (action == 50) {
-                        // Language Select
-                        returnState = STATE_LOGIN_SETTINGS;
-                        current_state = STATE_LANGUAGE_SELECT;
-                    }
-                    else { 
-                        // Login Selection (0, 1, or 2)
-                        targetUserIdx = action; 
-                        UI_ResetGrid(); 
-                        current_state = STATE_VERIFY_LOGIN; 
-                    }
-                }
-                needsRedraw = true; while(buttons[touch]) ReadCTMU(); delay(5000);
-            }
+        else if (cursorIndex == 3 && cfgActive && cfgAccType == ACC_MULTI) {
+            // Min value 2
+            if (touch==1 && cfgAccCount < 250) cfgAccCount++;
+            else if (touch==3 && cfgAccCount > 2) cfgAccCount--;
         }
-        else if (current_state == STATE_VERIFY_DOOR) {
-             if (touch != -1) {
-                idleTimer = 0;
-                if (!visitedMask[touch] && patternIdx < PATTERN_MAX) { patternBuf[patternIdx] = touch; visitedMask[touch] = true; GFX_DrawNode(btnX[touch], btnY[touch], true); if (patternIdx > 0) { uint8_t prev = patternBuf[patternIdx - 1]; GFX_DrawLine(btnX[prev], btnY[prev], btnX[touch], btnY[touch]); } SetRGBs(255, 255, 0); patternIdx++; }
+    }
+    // Select
+    else if (touch == 4) {
+        if (cursorIndex == 4) {
+            if (cfgIsNewUser) {
+                 State_Go(STATE_TUTORIAL);
             } else {
-                if (idleTimer == 1) SetRGBs(0, 0, 255);   
-                if (patternIdx > 0) {
-                    idleTimer++;
-                    if (idleTimer > TOUCH_TIMEOUT) {
-                        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
-                        if (CheckPassword(targetUserIdx)) { 
-                            bool accessAllowed = true;
-                            if (targetUserIdx != 0) { 
-                                if (ACCESS_TYPE[targetUserIdx] == ACC_ONETIME) { 
-                                    DeactivateUser(targetUserIdx); 
-                                } else if (ACCESS_TYPE[targetUserIdx] == ACC_MULTI) {
-                                    if (ACCESS_COUNT[targetUserIdx] > 0) {
-                                        ACCESS_COUNT[targetUserIdx]--;
-                                        if (ACCESS_COUNT[targetUserIdx] == 1) {
-                                            ACCESS_TYPE[targetUserIdx] = ACC_ONETIME;
-                                        } 
-                                        else if (ACCESS_COUNT[targetUserIdx] == 0) {
-                                            DeactivateUser(targetUserIdx);
-                                        }
-                                        else NVM_WriteAll(); 
-                                    } else {
-                                        accessAllowed = false; 
-                                    }
-                                }
-                            }
-                            if (accessAllowed) {
-                                UI_DrawString(25, 25, (char*)GetStr(S_DOOR_UNLOCKED)); SetRGBs(0, 255, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_SUCCESS); delay(40000); 
-                            } else {
-                                UI_DrawString(15, 25, (char*)GetStr(S_ACCESS_DENIED)); SetRGBs(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_FAIL); delay(40000);
-                            }
-                        } 
-                        else { UI_DrawString(15, 25, (char*)GetStr(S_INCORRECT_PASS)); SetRGBs(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_FAIL); delay(40000); }
-                        current_state = STATE_DOOR_OPEN_MENU; UI_ResetGrid(); idleTimer = 0;
-                    }
-                }
+                 USER_ACTIVE[targetUserIdx] = cfgActive;
+                 PERMISSIONS[targetUserIdx] = cfgPerm;
+                 ACCESS_TYPE[targetUserIdx] = cfgAccType;
+                 ACCESS_COUNT[targetUserIdx] = cfgAccCount;
+                 NVM_WriteAll();
+                 State_Go(STATE_PERMISSIONS);
+                 cursorIndex = targetUserIdx - 1;
             }
         }
-        else if (current_state == STATE_VERIFY_LOGIN) {
-             if (touch != -1) {
-                idleTimer = 0;
-                if (!visitedMask[touch] && patternIdx < PATTERN_MAX) { patternBuf[patternIdx] = touch; visitedMask[touch] = true; GFX_DrawNode(btnX[touch], btnY[touch], true); if (patternIdx > 0) { uint8_t prev = patternBuf[patternIdx - 1]; GFX_DrawLine(btnX[prev], btnY[prev], btnX[touch], btnY[touch]); } SetRGBs(255, 255, 0); patternIdx++; }
-            } else {
-                if (idleTimer == 1) SetRGBs(0, 0, 255);   
-                if (patternIdx > 0) {
-                    idleTimer++;
-                    if (idleTimer > TOUCH_TIMEOUT) {
-                        bool passOk = CheckPassword(targetUserIdx);
-                        if (passOk) { 
-                            currentUser = targetUserIdx; menuIndex = 0; current_state = STATE_MENU; Log_Add(targetUserIdx, LOG_TYPE_SETTINGS, LOG_STATUS_SUCCESS); 
-                        } 
-                        else { 
-                            SetColor(BLACK); ClearDevice(); SetColor(WHITE); 
-                            UI_DrawString(15, 25, (char*)GetStr(S_INCORRECT_PASS)); 
-                            SetRGBs(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_SETTINGS, LOG_STATUS_FAIL); delay(40000); current_state = STATE_LOGIN_SETTINGS; 
-                        }
-                        UI_ResetGrid(); idleTimer = 0;
+    }
+}
+
+// -- Log views --
+// Scrolling moves the view by one entry per event, the render catches up
+void LogRender(bool userView, uint8_t top, bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        for (uint8_t r = 0; r <= LOG_VIEW_ROWS; r++) UI_LogRow(userView, r, top);
+    } else if (top != logShown) UI_LogScroll(userView, top, top > logShown);
+    logShown = top;
+}
+
+void AdminLogsRender(bool full) {
+    LogRender(false, logScroll, full);
+}
+
+void AdminLogsEvent(int8_t touch) {
+    if (touch == 3) { State_Go(STATE_ADVANCED_MENU); menuIndex = 0; }
+    else if (touch == 2) { if (logScroll < logCount - 1) logScroll++; }
+    else if (touch == 0) { if (logScroll > 0) logScroll--; }
+}
+
+void UserLogsRender(bool full) {
+    LogRender(true, userLogScroll, full);
+}
+
+void UserLogsEvent(int8_t touch) {
+    int totalUserLogs = 0;
+    for(int k=0; k<logCount; k++) { if (ADMIN_LOGS[k].userIdx == currentUser) totalUserLogs++; }
+    if (touch == 3) { State_Go(STATE_MENU); menuIndex = 0; }
+    else if (touch == 2) { if (totalUserLogs > 0 && userLogScroll < totalUserLogs - 1) userLogScroll++; }
+    else if (touch == 0) { if (userLogScroll > 0) userLogScroll--; }
+}
+
+// -- Door and login menus --
+void DoorMenuEnter(void) {
+    menuCount = 0;
+    if (numUsers > 1 && PASS_LENS[1] > 0 && USER_ACTIVE[1]) UI_MenuAdd(S_OPEN_AS_G1, 1);
+    if (numUsers > 2 && PASS_LENS[2] > 0 && USER_ACTIVE[2]) UI_MenuAdd(S_OPEN_AS_G2, 2);
+    UI_MenuAdd(S_OPEN_AS_ADMIN, 0);
+    UI_MenuAdd(S_SETTINGS, -1);
+}
+
+void DoorMenuRender(bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(30, 5, (char*)GetStr(S_DOOR_MENU)); GFX_DrawLine(0, 15, 127, 15);
+        UI_MenuRows(20);
+        UI_MenuBegin(); SetRGBs(0, 0, 255);
+    }
+    UI_MenuCursor(20 + (menuIndex * 9));
+}
+
+void DoorMenuEvent(int8_t touch) {
+    if (DOOR_IDENTIFY_USER && touch == 3) { Door_Go(); return; }  // left goes back to the grid
+    if (touch != 4) { UI_MenuMove(touch); return; }
+    int action = dynamicMenuMap[menuIndex];
+    if (action == -1) { State_Go(STATE_LOGIN_SETTINGS); menuIndex = 0; }
+    else { targetUserIdx = action; doorAnyUser = false; State_Go(STATE_VERIFY_DOOR); }
+}
+
+void LoginMenuEnter(void) {
+    menuCount = 0;
+    if (numUsers > 1 && PASS_LENS[1] > 0 && USER_ACTIVE[1]) UI_MenuAdd(S_LOGIN_AS_G1, 1);  // User 1 (if active)
+    if (numUsers > 2 && PASS_LENS[2] > 0 && USER_ACTIVE[2]) UI_MenuAdd(S_LOGIN_AS_G2, 2);  // User 2 (if active)
+    UI_MenuAdd(S_LOGIN_AS_ADMIN, 0);
+    UI_MenuAdd(S_M_LANG, 50);  // Language Option (ID 50)
+    UI_MenuAdd(S_BACK, -1);
+}
+
+void LoginMenuRender(bool full) {
+    if (full) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        UI_DrawString(20, 5, (char*)GetStr(S_LOGIN_SETTINGS));
+        GFX_DrawLine(0, 15, 127, 15);
+        UI_MenuRows(20);
+        UI_MenuBegin();
+        SetRGBs(0, 0, 255); // Reset to Blue
+    }
+    UI_MenuCursor(20 + (menuIndex * 9));
+}
+
+void LoginMenuEvent(int8_t touch) {
+    if (touch != 4) { UI_MenuMove(touch); return; }
+    int action = dynamicMenuMap[menuIndex];
+    if (action == -1) {
+        // Back
+        Door_Go();
+    }
+    else if (action == 50) {
+        // Language Select
+        returnState = STATE_LOGIN_SETTINGS;
+        State_Go(STATE_LANGUAGE_SELECT);
+    }
+    else {
+        // Login Selection (0, 1, or 2)
+        targetUserIdx = action;
+        State_Go(STATE_VERIFY_LOGIN);
+    }
+}
+
+// -- Pattern entry: verifying for the door or a login, setting a password --
+void PatternEnter(void) {
+    Pattern_Reset();
+    Match_Begin(1 << targetUserIdx);
+}
+
+// the door matches every user it opens for when it is to find the user
+void DoorPatternEnter(void) {
+    Pattern_Reset();
+    Match_Begin(doorAnyUser ? Users_WithPattern() : 1 << targetUserIdx);
+}
+
+// the pattern just entered does not stay in RAM
+void PatternExit(void) {
+    for (uint8_t k = 0; k < PATTERN_MAX; k++) patternBuf[k] = 0;
+    Pattern_Reset();
+}
+
+void PatternRender(bool full) {
+    if (full) { DrawImage(0, 0, GetScreen(SCR_GRID)); patternShown = 0; }  // all hollow nodes, see scr2c.py
+    for (; patternShown < patternIdx; patternShown++) {
+        uint8_t node = patternBuf[patternShown];
+        GFX_DrawNode(btnX[node], btnY[node], true);
+        if (patternShown > 0) { uint8_t prev = patternBuf[patternShown - 1]; GFX_DrawLine(btnX[prev], btnY[prev], btnX[node], btnY[node]); }
+    }
+}
+
+void PatternEvent(int8_t touch) {
+    nodeHeld = true; nodeAt = Tick_Ms();
+    if (!visitedMask[touch] && patternIdx < PATTERN_MAX) { patternBuf[patternIdx] = touch; visitedMask[touch] = true; SetRGBs(255, 255, 0); Match_Node(patternIdx, touch); patternIdx++; }
+}
+
+// True when more nodes cannot change the outcome: all of them are used, or
+// the matcher accepted it. A rejected pattern waits out the pause unless
+// PATTERN_INSTANT_REJECT is set, so by default it does not tell at which
+// node it went wrong.
+bool Pattern_Settled(void) {
+    if (patternIdx >= PATTERN_MAX) return true;
+    if (current_state == STATE_SET_PATTERN) return false;
+    return matchResult == MATCH_ACCEPT || (PATTERN_INSTANT_REJECT && matchResult == MATCH_REJECT);
+}
+
+// Times the pause after the last node from its release, with the LED back at
+// the idle color. True once the pattern is to be submitted: after the pause
+// of the state, or as soon as it is settled with earlySubmit.
+bool Pattern_Ready(uint8_t r, uint8_t g, uint8_t b) {
+    const StateDef *st = &appStates[current_state];
+    if (patternIdx == 0 || patternShown < patternIdx) return false;  // the last node shows first
+    if (st->earlySubmit && Pattern_Settled()) return true;
+    if (Touch_ActivePad() >= 0) { nodeHeld = true; return false; }
+    if (nodeHeld) { nodeHeld = false; releasedAt = Tick_Ms(); SetRGBs(r, g, b); }
+    return Tick_Ms() - releasedAt >= st->submitMs;
+}
+
+void VerifyDoorTick(void) {
+    if (doorAnyUser && patternIdx == 1 && patternBuf[0] == 4 && Touch_ActivePad() == 4 && Tick_Ms() - nodeAt >= MENU_HOLD_MS) {
+        State_Go(STATE_DOOR_OPEN_MENU);  // a held center is no pattern, it asks for the menu
+        menuIndex = 0;
+        return;
+    }
+    if (!Pattern_Ready(0, 0, 255)) return;
+    if (doorAnyUser) targetUserIdx = matchExact ? matchUser : USER_NONE;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+    if (CheckPassword(targetUserIdx)) {
+        bool accessAllowed = true;
+        if (targetUserIdx != 0) {
+            if (ACCESS_TYPE[targetUserIdx] == ACC_ONETIME) {
+                DeactivateUser(targetUserIdx);
+            } else if (ACCESS_TYPE[targetUserIdx] == ACC_MULTI) {
+                if (ACCESS_COUNT[targetUserIdx] > 0) {
+                    ACCESS_COUNT[targetUserIdx]--;
+                    if (ACCESS_COUNT[targetUserIdx] == 1) {
+                        ACCESS_TYPE[targetUserIdx] = ACC_ONETIME;
                     }
-                }
-            }
-        }
-        else if (current_state == STATE_SET_PATTERN) {
-            if (touch != -1) {
-                idleTimer = 0;
-                if (!visitedMask[touch] && patternIdx < PATTERN_MAX) { patternBuf[patternIdx] = touch; visitedMask[touch] = true; GFX_DrawNode(btnX[touch], btnY[touch], true); if (patternIdx > 0) { uint8_t prev = patternBuf[patternIdx - 1]; GFX_DrawLine(btnX[prev], btnY[prev], btnX[touch], btnY[touch]); } SetRGBs(255, 255, 0); patternIdx++; }
-            } else {
-                if (idleTimer == 1) SetRGBs(100, 0, 100); 
-                if (patternIdx > 0) {
-                    idleTimer++;
-                    if (idleTimer > TOUCH_TIMEOUT) {
-                        SavePassword(targetUserIdx); 
-                        if (targetUserIdx > 0 && targetUserIdx == (numUsers - 1)) currentUser = targetUserIdx;
-                        SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(20, 25, (char*)GetStr(S_PASS_SAVED)); SetRGBs(0, 255, 0); delay(20000);
-                        current_state = STATE_MENU; menuIndex = 0; UI_ResetGrid(); idleTimer = 0;
+                    else if (ACCESS_COUNT[targetUserIdx] == 0) {
+                        DeactivateUser(targetUserIdx);
                     }
+                    else NVM_WriteAll();
+                } else {
+                    accessAllowed = false;
                 }
             }
         }
-        else if (current_state == STATE_ERROR_MSG) {
-             if (needsRedraw) { SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(5, 20, (char*)GetStr(S_MSG_USER_LIMIT_1)); UI_DrawString(5, 30, (char*)GetStr(S_MSG_USER_LIMIT_2)); UI_DrawString(5, 40, (char*)GetStr(S_MSG_USER_LIMIT_3)); SetRGBs(255, 0, 0); needsRedraw = false; }
-             if (touch != -1) { current_state = STATE_MENU; while(buttons[touch]) ReadCTMU(); delay(5000); }
+        if (accessAllowed) {
+            UI_DrawString(25, 25, (char*)GetStr(S_DOOR_UNLOCKED)); DrawImage(56, 40, IMG_UNLOCK); UI_ResultLED(0, 255, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_SUCCESS);
+        } else {
+            UI_DrawString(15, 25, (char*)GetStr(S_ACCESS_DENIED)); DrawImage(56, 40, IMG_LOCK); UI_ResultLED(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_FAIL);
         }
     }
+    else { UI_DrawString(15, 25, (char*)GetStr(S_INCORRECT_PASS)); DrawImage(56, 40, IMG_LOCK); UI_ResultLED(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_DOOR, LOG_STATUS_FAIL); }
+    doorAnyUser = DOOR_IDENTIFY_USER;
+    UI_Hold(RESULT_HOLD_MS, DOOR_IDENTIFY_USER ? STATE_VERIFY_DOOR : STATE_DOOR_OPEN_MENU);
+}
+
+void VerifyLoginTick(void) {
+    if (!Pattern_Ready(0, 0, 255)) return;
+    if (CheckPassword(targetUserIdx)) {
+        currentUser = targetUserIdx; menuIndex = 0; State_Go(STATE_MENU); Log_Add(targetUserIdx, LOG_TYPE_SETTINGS, LOG_STATUS_SUCCESS);
+    }
+    else {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE);
+        UI_DrawString(15, 25, (char*)GetStr(S_INCORRECT_PASS)); DrawImage(56, 40, IMG_LOCK);
+        UI_ResultLED(255, 0, 0); Log_Add(targetUserIdx, LOG_TYPE_SETTINGS, LOG_STATUS_FAIL); UI_Hold(RESULT_HOLD_MS, STATE_LOGIN_SETTINGS);
+    }
+}
+
+// When the door finds the user from the pattern, a new password is matched
+// against every other stored one, deactivated users' included, to refuse one
+// the door could not tell apart, now or once a user is active again. A refusal tells that the pattern is someone's, so it is handled like
+// a failed login: logged and held, each time longer, and after
+// PASS_TAKEN_MAX of them the door signs the user out. The count starts over
+// each time the user comes from a menu to set a password.
+
+void SetPatternEnter(void) {
+    Pattern_Reset();
+    Match_Begin(DOOR_IDENTIFY_USER ? Users_PatternStored() & ~(1 << targetUserIdx) : 0);
+    SetRGBs(100, 0, 100);
+}
+
+void SetPatternTick(void) {
+    if (!Pattern_Ready(100, 0, 100)) return;
+    if (matchExact) {
+        SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(20, 25, (char*)GetStr(S_PASS_TAKEN)); DrawImage(56, 40, IMG_LOCK);
+        UI_ResultLED(255, 0, 0); Log_Add(currentUser, LOG_TYPE_SETTINGS, LOG_STATUS_FAIL);
+        if (passTaken < PASS_TAKEN_MAX) passTaken++;
+        if (passTaken < PASS_TAKEN_MAX) UI_Hold(RESULT_HOLD_MS * passTaken, STATE_SET_PATTERN);  // draw another one
+        else { doorAnyUser = DOOR_IDENTIFY_USER; UI_Hold(RESULT_HOLD_MS * PASS_TAKEN_MAX, STATE_VERIFY_DOOR); }
+        return;
+    }
+    SavePassword(targetUserIdx);
+    if (targetUserIdx > 0 && targetUserIdx == (numUsers - 1)) currentUser = targetUserIdx;
+    SetColor(BLACK); ClearDevice(); SetColor(WHITE); UI_DrawString(20, 25, (char*)GetStr(S_PASS_SAVED)); UI_ResultLED(0, 255, 0);
+    UI_Hold(SAVED_HOLD_MS, STATE_MENU); menuIndex = 0;
+}
+
+// -- Error message --
+void ErrorRender(bool full) {
+    if (full) { DrawImage(0, 0, GetScreen(SCR_ERROR_MSG)); SetRGBs(255, 0, 0); }
+}
+
+void ErrorEvent(int8_t touch) {
+    State_Go(STATE_MENU);
+}
+
+#define MENU_    TOUCH_PROFILE_MENU
+#define PATTERN_ TOUCH_PROFILE_PATTERN
+const StateDef appStates[STATE_COUNT] = {
+    //                        onEnter          onExit       onEvent           onTick           onRender           profile   fastRepeat  submitMs             earlySubmit
+    [STATE_BOOT]            = { NULL,          NULL,        NULL,             NULL,            NULL,              MENU_,    false,      0,                   false },
+    [STATE_LANGUAGE_SELECT] = { NULL,          NULL,        LanguageEvent,    NULL,            LanguageRender,    MENU_,    false,      0,                   false },
+    [STATE_WELCOME]         = { NULL,          NULL,        WelcomeEvent,     NULL,            WelcomeRender,     MENU_,    false,      0,                   false },
+    [STATE_SET_DATE]        = { NULL,          NULL,        DateEvent,        NULL,            DateRender,        MENU_,    true,       0,                   false },
+    [STATE_SET_TIME]        = { NULL,          NULL,        TimeEvent,        NULL,            TimeRender,        MENU_,    true,       0,                   false },
+    [STATE_TUTORIAL]        = { NULL,          NULL,        TutorialEvent,    NULL,            TutorialRender,    MENU_,    false,      0,                   false },
+    [STATE_MENU]            = { MenuEnter,     NULL,        MenuEvent,        NULL,            MenuRender,        MENU_,    false,      0,                   false },
+    [STATE_ADVANCED_MENU]   = { AdvancedEnter, NULL,        AdvancedEvent,    NULL,            AdvancedRender,    MENU_,    false,      0,                   false },
+    [STATE_SET_PATTERN]     = { SetPatternEnter, PatternExit, PatternEvent,   SetPatternTick,  PatternRender,     PATTERN_, false,      NEW_PATTERN_IDLE_MS, true  },
+    [STATE_PERMISSIONS]     = { NULL,          NULL,        PermissionsEvent, NULL,            PermissionsRender, MENU_,    false,      0,                   false },
+    [STATE_USER_CONFIG]     = { NULL,          NULL,        ConfigEvent,      NULL,            ConfigRender,      MENU_,    true,       0,                   false },
+    [STATE_ADMIN_LOGS]      = { NULL,          NULL,        AdminLogsEvent,   NULL,            AdminLogsRender,   MENU_,    false,      0,                   false },
+    [STATE_USER_LOGS]       = { NULL,          NULL,        UserLogsEvent,    NULL,            UserLogsRender,    MENU_,    false,      0,                   false },
+    [STATE_DOOR_OPEN_MENU]  = { DoorMenuEnter, NULL,        DoorMenuEvent,    NULL,            DoorMenuRender,    MENU_,    false,      0,                   false },
+    [STATE_LOGIN_SETTINGS]  = { LoginMenuEnter, NULL,       LoginMenuEvent,   NULL,            LoginMenuRender,   MENU_,    false,      0,                   false },
+    [STATE_VERIFY_DOOR]     = { DoorPatternEnter, PatternExit, PatternEvent,  VerifyDoorTick,  PatternRender,     PATTERN_, false,      PATTERN_IDLE_MS,     true  },
+    [STATE_VERIFY_LOGIN]    = { PatternEnter,  PatternExit, PatternEvent,     VerifyLoginTick, PatternRender,     PATTERN_, false,      PATTERN_IDLE_MS,     true  },
+    [STATE_ERROR_MSG]       = { NULL,          NULL,        ErrorEvent,       NULL,            ErrorRender,       MENU_,    false,      0,                   false },
+};
+#undef MENU_
+#undef PATTERN_
+
+// Switches to the state State_Go() named
+void State_Enter(void) {
+    while (stateChange) {
+        stateChange = false;
+        const StateDef *st = &appStates[current_state];
+        if (st->onExit) st->onExit();
+        current_state = nextState;
+        st = &appStates[current_state];
+        Touch_SetProfile(st->profile);
+        Touch_SetRepeat(TOUCH_REPEAT_MS, st->fastRepeat ? TOUCH_REPEAT_FAST_MS : TOUCH_REPEAT_MS, TOUCH_REPEAT_SPEEDUP);  // values scroll faster the longer they are held
+        needsRedraw = true;
+        if (st->onEnter) st->onEnter();
+    }
+}
+
+// --- Main Application ---
+
+int main(void) {
+    TouchCal cal;
+    uint8_t firstState;
+    INIT_CLOCK(); Tick_Init(); CTMUInit(NVM_ReadCal(&cal) ? &cal : NULL); RGBMapColorPins(); RGBTurnOnLED(); ResetDevice(); RTCC_Init();
+    DrawImage(0, 0, IMG_LOGO); FlushDevice();  // boot logo
+    bool dataLoaded = NVM_ReadAll();
+
+    if (!dataLoaded || numUsers == 0) {
+        numUsers = 0; currentUser = 0; targetUserIdx = 0;
+        PERMISSIONS[0] = 1; ACCESS_TYPE[0] = ACC_PERMANENT; USER_ACTIVE[0] = 1;
+        sysLanguage = 0;
+        firstState = STATE_LANGUAGE_SELECT;
+    } else {
+        currentUser = 0;
+        firstState = STATE_SET_DATE;
+        cursorIndex = 0;
+    }
+
+    SetRGBs(0, 0, 255);
+    UI_Hold(LOGO_HOLD_MS, firstState);  // leave the logo up for a moment
+
+    while(1) {
+        Touch_Update();  // one pass per touch scan, waits for the next one
+        Sched_Run();     // timers due by now
+        if (Touch_ActivePad() < 0 && Touch_CalibrationDue()) {  // settled, keep it for the next boot
+            Touch_GetCalibration(&cal); NVM_WriteCal(&cal);
+        }
+        // act on a press as soon as it qualifies; held arrows repeat, center does not
+        int8_t touch = -1;
+        TouchEvent ev;
+        if (Touch_PollEvent(&ev) && (ev.type == TOUCH_PRESS || (ev.type == TOUCH_REPEAT && ev.pad != 4)))
+            touch = ev.pad;
+
+        // --- STATE MACHINE ---
+        if (!Timer_Running(&holdTimer)) {  // a held screen pauses it, touches are dropped
+#ifdef STATE_TIMING
+            uint32_t start = Tick_Us();
+#endif
+            const StateDef *st;
+            State_Enter();
+            st = &appStates[current_state];
+            if (touch >= 0 && st->onEvent) st->onEvent(touch);
+            if (st->onTick) st->onTick();
+            State_Enter();
+            st = &appStates[current_state];
+            if (st->onRender) st->onRender(needsRedraw);
+            needsRedraw = false;
+#ifdef STATE_TIMING
+            uint32_t us = Tick_Us() - start;
+            if (us > stateWorstUs[current_state]) stateWorstUs[current_state] = (us > 0xFFFF) ? 0xFFFF : us;
+#endif
+        }
+        FlushDevice();  // send whatever this pass drew in one burst
+    }
     return 0;
-}
\ No newline at end of file
+}
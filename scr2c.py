@@ -0,0 +1,208 @@
+import re
+import datetime
+
+from po2c import parse_po
+
+WIDTH = 128
+PAGES = 8
+
+# Characters that the firmware font stores at codes 123..129 (see po2c.py)
+SPECIAL_CODES = {'Ä': 123, 'Ö': 124, 'Ü': 125, 'ä': 126, 'ö': 127, 'ü': 128, 'ß': 129}
+
+def load_font(filename='Font5x7.c'):
+    """Returns the glyph table of Font5x7.c, index 0 is the space (code 32)."""
+    with open(filename, 'r', encoding='utf-8') as f:
+        content = f.read()
+    glyphs = re.findall(r'\{\s*(0x[0-9A-Fa-f]{2}(?:\s*,\s*0x[0-9A-Fa-f]{2}){4})\s*\}', content)
+    return [[int(v, 16) for v in g.split(',')] for g in glyphs]
+
+def load_nodes(filename='main.c'):
+    """Reads the node positions btnX/btnY so the grid matches the firmware."""
+    with open(filename, 'r', encoding='latin-1') as f:
+        content = f.read()
+    xs = re.search(r'btnX\[5\]\s*=\s*\{([^}]*)\}', content).group(1)
+    ys = re.search(r'btnY\[5\]\s*=\s*\{([^}]*)\}', content).group(1)
+    return list(zip([int(v) for v in xs.split(',')], [int(v) for v in ys.split(',')]))
+
+class Canvas:
+    """1bpp image in display page format, drawn like the firmware helpers."""
+    def __init__(self, width=WIDTH, pages=PAGES):
+        self.width = width
+        self.pages = [[0] * width for _ in range(pages)]
+
+    def pixel(self, x, y):
+        if 0 <= x < self.width and 0 <= y < len(self.pages) * 8:
+            self.pages[y >> 3][x] |= 1 << (y & 7)
+
+    def line(self, x0, y0, x1, y1):  # same pixels as GFX_DrawLine
+        dx, sx = abs(x1 - x0), 1 if x0 < x1 else -1
+        dy, sy = -abs(y1 - y0), 1 if y0 < y1 else -1
+        err = dx + dy
+        while True:
+            self.pixel(x0, y0)
+            if x0 == x1 and y0 == y1:
+                break
+            e2 = 2 * err
+            if e2 >= dy:
+                err += dy
+                x0 += sx
+            if e2 <= dx:
+                err += dx
+                y0 += sy
+
+    def node(self, x, y):  # hollow GFX_DrawNode
+        for dx, dy in ((0, -3), (0, 3), (-3, 0), (3, 0), (-1, -2), (1, -2), (-2, -1),
+                       (2, -1), (-2, 1), (2, 1), (-1, 2), (1, 2)):
+            self.pixel(x + dx, y + dy)
+
+    def text(self, x, y, s, font):  # same glyphs as UI_DrawString
+        for ch in s:
+            code = SPECIAL_CODES.get(ch, ord(ch))
+            if code < 32 or code > 129:
+                code = 32
+            for i, column in enumerate(font[code - 32]):
+                for j in range(8):
+                    if column & (1 << j):
+                        self.pixel(x + i, y + j)
+            x += 6
+
+def rle_encode(data):
+    """Run-length codes a byte list for DrawImage(): a control byte c < 0x80
+    is followed by c+1 literal bytes, c >= 0x80 by one byte that repeats
+    (c & 0x7F) + 2 times."""
+    out = []
+    literal = []
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 129:
+            run += 1
+        if run >= 2:
+            if literal:
+                out += [len(literal) - 1] + literal
+                literal = []
+            out += [0x80 | (run - 2), data[i]]
+            i += run
+        else:
+            literal.append(data[i])
+            if len(literal) == 128:
+                out += [len(literal) - 1] + literal
+                literal = []
+            i += 1
+    if literal:
+        out += [len(literal) - 1] + literal
+    return out
+
+def encode_image(canvas):
+    """Header (width, pages) followed by the RLE coded pages."""
+    data = [b for page in canvas.pages for b in page]
+    return [canvas.width, len(canvas.pages)] + rle_encode(data)
+
+def c_array(name, data, comment):
+    lines = [f'// {comment}: {len(data)} bytes', f'const uint8_t {name}[{len(data)}] = {{']
+    for i in range(0, len(data), 16):
+        lines.append('    ' + ', '.join(f'0x{b:02X}' for b in data[i:i + 16]) + ',')
+    lines.append('};\n')
+    return '\n'.join(lines)
+
+# Screen layouts, must match the UI_DrawString/GFX_DrawLine calls they replace
+def screen_welcome(t, font):
+    c = Canvas()
+    c.text(40, 25, t['S_WELCOME'], font)
+    c.text(10, 40, t['S_PRESS_CENTER'], font)
+    return c
+
+def screen_tutorial(t, font):
+    c = Canvas()
+    c.text(5, 5, t['S_TUTORIAL_TITLE'], font)
+    c.line(0, 15, 127, 15)
+    c.text(5, 25, t['S_TUT_1'], font)
+    c.text(5, 35, t['S_TUT_2'], font)
+    c.text(5, 45, t['S_TUT_3'], font)
+    c.text(5, 55, t['S_PRESS_CENTER'], font)
+    return c
+
+def screen_error(t, font):
+    c = Canvas()
+    c.text(5, 20, t['S_MSG_USER_LIMIT_1'], font)
+    c.text(5, 30, t['S_MSG_USER_LIMIT_2'], font)
+    c.text(5, 40, t['S_MSG_USER_LIMIT_3'], font)
+    return c
+
+def screen_grid(nodes):
+    c = Canvas()
+    for x, y in nodes:
+        c.node(x, y)
+    return c
+
+SCREENS = [
+    ('SCR_WELCOME', screen_welcome),
+    ('SCR_TUTORIAL', screen_tutorial),
+    ('SCR_ERROR_MSG', screen_error),
+]
+
+def generate_c_files():
+    font = load_font()
+    en_data, _ = parse_po('en.po')
+    de_data, _ = parse_po('de.po')
+    if not en_data or not font:
+        print("Missing strings or font data. Aborting.")
+        return
+    languages = [('en', en_data), ('de', {**en_data, **de_data})]  # EN fallback
+
+    # --- Header File (.h) ---
+    h_content = f"""/* Generated by scr2c.py on {datetime.datetime.now()} */
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <stdint.h>
+#include "languages.h"
+
+// Pre-rendered full screen page images, drawn with DrawImage(0, 0, ...)
+enum ScreenID {{
+"""
+    for i, (key, _) in enumerate(SCREENS):
+        h_content += f"    {key} = {i},\n"
+    h_content += f"""    SCR_GRID = {len(SCREENS)},
+    SCR_COUNT
+}};
+
+// Screen Table
+extern const uint8_t* const SCREENS[2][SCR_COUNT];
+
+// Helper Macro
+#define GetScreen(id) SCREENS[sysLanguage][id]
+
+#endif // SCREENS_H
+"""
+    with open('screens.h', 'w') as f:
+        f.write(h_content)
+
+    # --- Source File (.c) ---
+    c_content = f"""/* Generated by scr2c.py on {datetime.datetime.now()} */
+#include "screens.h"
+
+"""
+    total = 0
+    for lang, texts in languages:
+        for key, build in SCREENS:
+            data = encode_image(build(texts, font))
+            total += len(data)
+            c_content += c_array(f'{key}_{lang}', data, f'{key} ({lang})') + '\n'
+    grid = encode_image(screen_grid(load_nodes()))
+    total += len(grid)
+    c_content += c_array('SCR_GRID_all', grid, 'SCR_GRID (all languages)') + '\n'
+
+    c_content += "const uint8_t* const SCREENS[2][SCR_COUNT] = {\n"
+    for lang, _ in languages:
+        names = ', '.join(f'{key}_{lang}' for key, _ in SCREENS)
+        c_content += f"    {{ {names}, SCR_GRID_all }},\n"
+    c_content += "};\n"
+
+    with open('screens.c', 'w') as f:
+        f.write(c_content)
+
+    print(f"Generated screens.h and screens.c successfully ({total} bytes).")
+
+if __name__ == "__main__":
+    generate_c_files()
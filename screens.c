@@ -0,0 +1,178 @@
+/* Generated by scr2c.py on 2026-10-15 23:18:12.597146 */
+#include "screens.h"
+
+// SCR_WELCOME (en): 151 bytes
+const uint8_t SCR_WELCOME_en[151] = {
+    0x80, 0x08, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xA3, 0x00, 0x06, 0x7E, 0x80, 0x70, 0x80, 0x7E,
+    0x00, 0x70, 0x81, 0xA8, 0x00, 0x30, 0x80, 0x00, 0x02, 0x82, 0xFE, 0x80, 0x80, 0x00, 0x00, 0x70,
+    0x81, 0x88, 0x02, 0x40, 0x00, 0x70, 0x81, 0x88, 0x08, 0x70, 0x00, 0xF8, 0x08, 0x30, 0x08, 0xF0,
+    0x00, 0x70, 0x81, 0xA8, 0x00, 0x30, 0x81, 0x00, 0x00, 0xBE, 0xFF, 0x00, 0xB2, 0x00, 0x00, 0x7F,
+    0x81, 0x09, 0x03, 0x06, 0x00, 0x7C, 0x08, 0x80, 0x04, 0x02, 0x08, 0x00, 0x38, 0x81, 0x54, 0x02,
+    0x18, 0x00, 0x48, 0x81, 0x54, 0x02, 0x20, 0x00, 0x48, 0x81, 0x54, 0x00, 0x20, 0x85, 0x00, 0x00,
+    0x3E, 0x81, 0x41, 0x02, 0x22, 0x00, 0x38, 0x81, 0x54, 0x03, 0x18, 0x00, 0x7C, 0x08, 0x80, 0x04,
+    0x08, 0x78, 0x00, 0x04, 0x3F, 0x44, 0x40, 0x20, 0x00, 0x38, 0x81, 0x54, 0x03, 0x18, 0x00, 0x7C,
+    0x08, 0x80, 0x04, 0x00, 0x08, 0x80, 0x00, 0x80, 0x60, 0x82, 0x00, 0x80, 0x60, 0x82, 0x00, 0x80,
+    0x60, 0xFF, 0x00, 0xFF, 0x00, 0x9B, 0x00,
+};
+
+// SCR_TUTORIAL (en): 606 bytes
+const uint8_t SCR_TUTORIAL_en[606] = {
+    0x80, 0x08, 0x83, 0x00, 0x80, 0x20, 0x00, 0xE0, 0x80, 0x20, 0x01, 0x00, 0x80, 0x81, 0x00, 0x04,
+    0x80, 0x00, 0x80, 0xE0, 0x80, 0x82, 0x00, 0x81, 0x80, 0x80, 0x00, 0x01, 0x80, 0x00, 0x80, 0x80,
+    0x81, 0x00, 0x01, 0x80, 0xA0, 0x82, 0x00, 0x81, 0x80, 0x81, 0x00, 0x01, 0x20, 0xE0, 0xCC, 0x00,
+    0x85, 0x80, 0x00, 0x8F, 0x81, 0x80, 0x00, 0x87, 0x80, 0x88, 0x01, 0x84, 0x8F, 0x80, 0x80, 0x00,
+    0x87, 0x80, 0x88, 0x02, 0x84, 0x80, 0x87, 0x81, 0x88, 0x03, 0x87, 0x80, 0x8F, 0x81, 0x80, 0x80,
+    0x00, 0x81, 0x80, 0x80, 0x02, 0x88, 0x8F, 0x88, 0x80, 0x80, 0x00, 0x84, 0x81, 0x8A, 0x00, 0x8F,
+    0x80, 0x80, 0x02, 0x88, 0x8F, 0x88, 0xCB, 0x80, 0xFF, 0x00, 0x83, 0x00, 0x02, 0x82, 0xFE, 0x82,
+    0x80, 0x00, 0x01, 0xF8, 0x10, 0x80, 0x08, 0x00, 0xF0, 0x85, 0x00, 0x07, 0x08, 0x7E, 0x88, 0x80,
+    0x40, 0x00, 0xFE, 0x10, 0x80, 0x08, 0x02, 0xF0, 0x00, 0x70, 0x81, 0xA8, 0x00, 0x30, 0x85, 0x00,
+    0x01, 0xF8, 0x10, 0x80, 0x08, 0x02, 0xF0, 0x00, 0x70, 0x81, 0xA8, 0x0C, 0x30, 0x00, 0x88, 0x50,
+    0x20, 0x50, 0x88, 0x00, 0x08, 0x7E, 0x88, 0x80, 0x40, 0x85, 0x00, 0x00, 0x90, 0x81, 0xA8, 0x02,
+    0x40, 0x00, 0x70, 0x81, 0x88, 0x03, 0x40, 0x00, 0xF8, 0x10, 0x80, 0x08, 0x02, 0x10, 0x00, 0x70,
+    0x81, 0xA8, 0x02, 0x30, 0x00, 0x70, 0x81, 0xA8, 0x03, 0x30, 0x00, 0xF8, 0x10, 0x80, 0x08, 0x00,
+    0xF0, 0x93, 0x00, 0x00, 0x60, 0x81, 0x80, 0x02, 0xE0, 0x00, 0xC0, 0x81, 0x20, 0x02, 0xC0, 0x00,
+    0xE0, 0x81, 0x00, 0x00, 0xE0, 0x85, 0x00, 0x00, 0xC0, 0x80, 0x20, 0x04, 0x40, 0xF8, 0x00, 0xE0,
+    0x40, 0x80, 0x20, 0x00, 0x40, 0x80, 0x00, 0x81, 0xA0, 0x06, 0xC0, 0x00, 0xE0, 0x00, 0x80, 0x00,
+    0xE0, 0x86, 0x00, 0x81, 0xA0, 0x00, 0xC0, 0x85, 0x00, 0x00, 0xE0, 0x81, 0xA0, 0x00, 0x40, 0x80,
+    0x00, 0x81, 0xA0, 0x04, 0xC0, 0x00, 0x20, 0xF8, 0x20, 0x81, 0x00, 0x02, 0x20, 0xF8, 0x20, 0x81,
+    0x00, 0x00, 0xC0, 0x81, 0xA0, 0x03, 0xC0, 0x00, 0xE0, 0x40, 0x80, 0x20, 0x03, 0x40, 0x00, 0xE0,
+    0x40, 0x80, 0x20, 0x00, 0xC0, 0x94, 0x00, 0x81, 0x82, 0x02, 0x01, 0x00, 0x01, 0x81, 0x82, 0x02,
+    0x01, 0x00, 0x01, 0x80, 0x02, 0x03, 0x01, 0x03, 0x00, 0x80, 0x81, 0x00, 0x02, 0x80, 0x00, 0x01,
+    0x81, 0x82, 0x02, 0x03, 0x00, 0x83, 0x81, 0x00, 0x03, 0x80, 0x00, 0x81, 0x02, 0x80, 0x82, 0x07,
+    0x03, 0x00, 0x01, 0x02, 0x01, 0x02, 0x01, 0x00, 0x82, 0x80, 0x80, 0x00, 0x00, 0x01, 0x81, 0x82,
+    0x00, 0x03, 0x80, 0x00, 0x81, 0x80, 0x80, 0x00, 0x00, 0x03, 0x81, 0x80, 0x80, 0x00, 0x00, 0x81,
+    0x81, 0x02, 0x00, 0x83, 0x80, 0x00, 0x00, 0x81, 0x80, 0x82, 0x03, 0x01, 0x00, 0x80, 0x01, 0x80,
+    0x82, 0x02, 0x01, 0x00, 0x01, 0x80, 0x82, 0x03, 0x02, 0xE0, 0x00, 0x03, 0x83, 0x00, 0x00, 0x03,
+    0x81, 0x00, 0x00, 0x03, 0x93, 0x00, 0x00, 0x84, 0x81, 0x8A, 0x02, 0x0F, 0x00, 0x09, 0x81, 0x0A,
+    0x00, 0x04, 0x85, 0x00, 0x00, 0x01, 0x81, 0x0A, 0x02, 0x07, 0x00, 0x07, 0x81, 0x08, 0x02, 0x07,
+    0x00, 0x07, 0x80, 0x08, 0x04, 0x04, 0x0F, 0x00, 0x0F, 0x81, 0x80, 0x80, 0x00, 0x01, 0x85, 0x00,
+    0x00, 0x0F, 0x81, 0x02, 0x03, 0x01, 0x00, 0x04, 0x8A, 0x80, 0x0A, 0x02, 0x0F, 0x00, 0x09, 0x81,
+    0x0A, 0x02, 0x04, 0x00, 0x09, 0x81, 0x0A, 0x08, 0x04, 0x00, 0x07, 0x08, 0x06, 0x08, 0x07, 0x00,
+    0x07, 0x81, 0x08, 0x03, 0x07, 0x00, 0x0F, 0x01, 0x80, 0x00, 0x02, 0x01, 0x00, 0x07, 0x80, 0x08,
+    0x01, 0x09, 0x0F, 0x80, 0x00, 0x80, 0x0C, 0x9B, 0x00, 0x00, 0x3F, 0x81, 0x04, 0x03, 0x03, 0x00,
+    0x3E, 0x04, 0x80, 0x02, 0x02, 0x04, 0x00, 0x1C, 0x81, 0x2A, 0x02, 0x0C, 0x00, 0x24, 0x81, 0x2A,
+    0x02, 0x10, 0x00, 0x24, 0x81, 0x2A, 0x00, 0x10, 0x85, 0x00, 0x00, 0x1F, 0x81, 0x20, 0x02, 0x11,
+    0x00, 0x1C, 0x81, 0x2A, 0x03, 0x0C, 0x00, 0x3E, 0x04, 0x80, 0x02, 0x08, 0x3C, 0x00, 0x02, 0x1F,
+    0x22, 0x20, 0x10, 0x00, 0x1C, 0x81, 0x2A, 0x03, 0x0C, 0x00, 0x3E, 0x04, 0x80, 0x02, 0x00, 0x04,
+    0x80, 0x00, 0x80, 0x30, 0x82, 0x00, 0x80, 0x30, 0x82, 0x00, 0x80, 0x30, 0xA2, 0x00,
+};
+
+// SCR_ERROR_MSG (en): 287 bytes
+const uint8_t SCR_ERROR_MSG_en[287] = {
+    0x80, 0x08, 0xFF, 0x00, 0xFF, 0x00, 0x81, 0x00, 0x00, 0xE0, 0x81, 0x10, 0x03, 0x20, 0x00, 0xC0,
+    0x80, 0x80, 0x40, 0x02, 0x80, 0x00, 0x80, 0x81, 0x40, 0x00, 0x80, 0x80, 0x00, 0x81, 0x40, 0x04,
+    0x80, 0x00, 0x40, 0xF0, 0x40, 0x82, 0x00, 0x01, 0x40, 0xD0, 0x81, 0x00, 0x01, 0xC0, 0x80, 0x80,
+    0x40, 0x02, 0x80, 0x00, 0xC0, 0x81, 0x20, 0x00, 0xE0, 0x85, 0x00, 0x06, 0xC0, 0x40, 0x80, 0x40,
+    0x80, 0x00, 0x80, 0x81, 0x40, 0x03, 0x80, 0x00, 0xC0, 0x80, 0x80, 0x40, 0x02, 0x80, 0x00, 0x80,
+    0x81, 0x40, 0x00, 0x80, 0xB1, 0x00, 0x00, 0x03, 0x81, 0x04, 0x02, 0x02, 0x00, 0x07, 0x83, 0x00,
+    0x00, 0x03, 0x81, 0x05, 0x02, 0x01, 0x00, 0x02, 0x81, 0x05, 0x00, 0x07, 0x80, 0x00, 0x00, 0x03,
+    0x80, 0x04, 0x00, 0x02, 0x80, 0x00, 0x02, 0x04, 0x07, 0x04, 0x80, 0x00, 0x04, 0x07, 0x00, 0x40,
+    0x00, 0x07, 0x80, 0x00, 0x81, 0x05, 0x00, 0x03, 0x85, 0x00, 0x06, 0x07, 0x00, 0x01, 0x00, 0x07,
+    0x00, 0x03, 0x81, 0x04, 0x03, 0x03, 0x00, 0x07, 0xC0, 0x82, 0x00, 0x00, 0x03, 0x81, 0x05, 0x00,
+    0x01, 0xB1, 0x00, 0x00, 0x0F, 0x80, 0x10, 0x03, 0x08, 0x1F, 0x00, 0x12, 0x81, 0x15, 0x02, 0x08,
+    0x00, 0x0E, 0x81, 0x15, 0x03, 0x06, 0x00, 0x1F, 0x02, 0x80, 0x01, 0x02, 0x02, 0x00, 0x12, 0x81,
+    0x15, 0x00, 0x08, 0x86, 0x00, 0x02, 0x11, 0x1F, 0x10, 0x80, 0x00, 0x00, 0x12, 0x81, 0x15, 0x00,
+    0x08, 0x85, 0x00, 0x01, 0x1F, 0x02, 0x80, 0x01, 0x02, 0x1E, 0x00, 0x0E, 0x81, 0x11, 0x06, 0x0E,
+    0x00, 0x01, 0x0F, 0x11, 0x10, 0x08, 0xB7, 0x00, 0x00, 0x20, 0x81, 0x54, 0x00, 0x78, 0x80, 0x00,
+    0x02, 0x41, 0x7F, 0x40, 0x81, 0x00, 0x02, 0x41, 0x7F, 0x40, 0x80, 0x00, 0x00, 0x38, 0x81, 0x44,
+    0x08, 0x38, 0x00, 0x3C, 0x40, 0x30, 0x40, 0x3C, 0x00, 0x38, 0x81, 0x54, 0x02, 0x18, 0x00, 0x38,
+    0x80, 0x44, 0x01, 0x48, 0x7F, 0x80, 0x00, 0x80, 0x60, 0xFF, 0x00, 0xFF, 0x00, 0xCA, 0x00,
+};
+
+// SCR_WELCOME (de): 190 bytes
+const uint8_t SCR_WELCOME_de[190] = {
+    0x80, 0x08, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xA3, 0x00, 0x04, 0x7E, 0x80, 0x70, 0x80, 0x7E,
+    0x80, 0x00, 0x02, 0x88, 0xFA, 0x80, 0x81, 0x00, 0x02, 0x82, 0xFE, 0x80, 0x81, 0x00, 0x02, 0x82,
+    0xFE, 0x80, 0x80, 0x00, 0x03, 0xFE, 0x20, 0x50, 0x88, 0x80, 0x00, 0x00, 0x70, 0x81, 0x88, 0x0E,
+    0x70, 0x00, 0xF8, 0x08, 0x30, 0x08, 0xF0, 0x00, 0xF8, 0x08, 0x30, 0x08, 0xF0, 0x00, 0x70, 0x81,
+    0xA8, 0x03, 0x30, 0x00, 0xF8, 0x10, 0x80, 0x08, 0x00, 0xF0, 0x81, 0x00, 0x00, 0xBE, 0xFF, 0x00,
+    0xA0, 0x00, 0x00, 0x7F, 0x80, 0x41, 0x04, 0x22, 0x1C, 0x00, 0x7C, 0x08, 0x80, 0x04, 0x08, 0x08,
+    0x00, 0x3C, 0x41, 0x40, 0x41, 0x7C, 0x00, 0x38, 0x81, 0x44, 0x05, 0x20, 0x00, 0x7F, 0x10, 0x28,
+    0x44, 0x80, 0x00, 0x00, 0x38, 0x81, 0x54, 0x03, 0x18, 0x00, 0x7C, 0x08, 0x80, 0x04, 0x00, 0x78,
+    0x85, 0x00, 0x00, 0x46, 0x81, 0x49, 0x00, 0x31, 0x80, 0x00, 0x02, 0x44, 0x7D, 0x40, 0x80, 0x00,
+    0x00, 0x38, 0x81, 0x54, 0x00, 0x18, 0x85, 0x00, 0x04, 0x7F, 0x02, 0x0C, 0x02, 0x7F, 0x80, 0x00,
+    0x02, 0x44, 0x7D, 0x40, 0x80, 0x00, 0x0C, 0x04, 0x3F, 0x44, 0x40, 0x20, 0x00, 0x04, 0x3F, 0x44,
+    0x40, 0x20, 0x00, 0x38, 0x81, 0x54, 0x00, 0x18, 0xFF, 0x00, 0xFF, 0x00, 0x8D, 0x00,
+};
+
+// SCR_TUTORIAL (de): 629 bytes
+const uint8_t SCR_TUTORIAL_de[629] = {
+    0x80, 0x08, 0x83, 0x00, 0x00, 0xC0, 0x81, 0x20, 0x03, 0xC0, 0x00, 0x80, 0x00, 0x80, 0x80, 0x81,
+    0x00, 0x01, 0x20, 0xE0, 0x82, 0x00, 0x81, 0x80, 0x81, 0x00, 0x01, 0x80, 0xA0, 0x81, 0x00, 0x02,
+    0x80, 0xE0, 0x80, 0x81, 0x00, 0x00, 0x80, 0x81, 0x00, 0x03, 0x80, 0x00, 0x80, 0x00, 0x80, 0x80,
+    0x80, 0x00, 0x00, 0x80, 0x81, 0x40, 0x00, 0xC0, 0xC4, 0x00, 0x83, 0x80, 0x00, 0x8F, 0x81, 0x82,
+    0x03, 0x8F, 0x80, 0x8F, 0x81, 0x80, 0x80, 0x00, 0x8F, 0x80, 0x80, 0x02, 0x88, 0x8F, 0x88, 0x80,
+    0x80, 0x00, 0x87, 0x81, 0x8A, 0x00, 0x83, 0x80, 0x80, 0x02, 0x88, 0x8F, 0x88, 0x81, 0x80, 0x00,
+    0x87, 0x80, 0x88, 0x02, 0x84, 0x80, 0x87, 0x80, 0x88, 0x04, 0x84, 0x8F, 0x80, 0x8F, 0x81, 0x80,
+    0x80, 0x02, 0x8F, 0x80, 0x81, 0x81, 0x8A, 0x00, 0x87, 0xC4, 0x80, 0xFF, 0x00, 0x83, 0x00, 0x02,
+    0x82, 0xFE, 0x82, 0x80, 0x00, 0x04, 0xF8, 0x08, 0x30, 0x08, 0xF0, 0x85, 0x00, 0x01, 0xF8, 0x10,
+    0x80, 0x08, 0x08, 0xF0, 0x00, 0x40, 0xAA, 0xA8, 0xAA, 0xF0, 0x00, 0x70, 0x81, 0x88, 0x03, 0x40,
+    0x00, 0xFE, 0x10, 0x80, 0x08, 0x02, 0xF0, 0x00, 0x90, 0x81, 0xA8, 0x08, 0x40, 0x00, 0x08, 0x7E,
+    0x88, 0x80, 0x40, 0x00, 0x70, 0x81, 0xA8, 0x03, 0x30, 0x00, 0xF8, 0x10, 0x80, 0x08, 0x00, 0xF0,
+    0x85, 0x00, 0x00, 0xFE, 0x81, 0x92, 0x00, 0x6C, 0x80, 0x00, 0x02, 0x88, 0xFA, 0x80, 0x81, 0x00,
+    0x02, 0x82, 0xFE, 0x80, 0x80, 0x00, 0x00, 0x70, 0x80, 0x88, 0x01, 0x90, 0xFE, 0x9F, 0x00, 0x00,
+    0xC0, 0x81, 0xA0, 0x00, 0xC0, 0x80, 0x00, 0x01, 0x20, 0xE8, 0x81, 0x00, 0x01, 0xE0, 0x40, 0x80,
+    0x20, 0x00, 0xC0, 0x85, 0x00, 0x06, 0xF8, 0x10, 0x60, 0x10, 0xF8, 0x00, 0xE0, 0x81, 0x00, 0x02,
+    0xE0, 0x00, 0x40, 0x81, 0xA0, 0x80, 0x00, 0x02, 0x20, 0xF8, 0x20, 0x81, 0x00, 0x00, 0xC0, 0x81,
+    0xA0, 0x03, 0xC0, 0x00, 0xE0, 0x40, 0x80, 0x20, 0x00, 0x40, 0x86, 0x00, 0x81, 0xA0, 0x00, 0xC0,
+    0x80, 0x00, 0x01, 0x08, 0xF8, 0x81, 0x00, 0x00, 0x40, 0x81, 0xA0, 0xAC, 0x00, 0x00, 0xE1, 0x81,
+    0x22, 0x00, 0xC0, 0x80, 0x00, 0x02, 0x82, 0x83, 0x82, 0x80, 0x00, 0x00, 0x03, 0x81, 0x80, 0x00,
+    0x03, 0x80, 0x00, 0x81, 0x80, 0x80, 0x00, 0x00, 0x83, 0x81, 0x00, 0x02, 0x83, 0x00, 0x01, 0x80,
+    0x82, 0x04, 0x81, 0x03, 0x00, 0x82, 0x02, 0x80, 0x82, 0x08, 0x01, 0x00, 0x80, 0xE1, 0x82, 0x02,
+    0x01, 0x00, 0x01, 0x81, 0x02, 0x80, 0x00, 0x00, 0x83, 0x82, 0x80, 0x80, 0x00, 0x81, 0x80, 0x80,
+    0x00, 0x04, 0x01, 0x82, 0xA2, 0x02, 0x03, 0x80, 0x00, 0x02, 0x82, 0x83, 0x82, 0x80, 0x00, 0x01,
+    0xE2, 0x02, 0x80, 0x82, 0x03, 0x01, 0x00, 0x80, 0x00, 0x80, 0x80, 0x81, 0x00, 0x81, 0x80, 0x80,
+    0x00, 0x01, 0x80, 0x00, 0x80, 0x80, 0x9A, 0x00, 0x00, 0x8F, 0x80, 0x81, 0x00, 0x01, 0x80, 0x00,
+    0x00, 0x04, 0x81, 0x0A, 0x08, 0x0F, 0x00, 0x09, 0x8A, 0x0A, 0x8A, 0x04, 0x00, 0x09, 0x81, 0x0A,
+    0x08, 0x04, 0x00, 0x87, 0x08, 0x06, 0x08, 0x07, 0x00, 0x07, 0x81, 0x08, 0x03, 0x07, 0x00, 0x0F,
+    0x01, 0x80, 0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x07, 0x80, 0x08, 0x00, 0x04, 0x80, 0x00, 0x82,
+    0x80, 0x07, 0x00, 0x08, 0x0C, 0x8A, 0x09, 0x08, 0x00, 0x07, 0x81, 0x0A, 0x00, 0x03, 0x80, 0x00,
+    0x02, 0x08, 0x0F, 0x08, 0x80, 0x00, 0x00, 0x87, 0x81, 0x08, 0x09, 0x84, 0x00, 0x0F, 0x01, 0x80,
+    0x00, 0x0F, 0x00, 0x0F, 0x81, 0x80, 0x00, 0x03, 0x0F, 0x00, 0x07, 0x8A, 0x80, 0x0A, 0x03, 0x03,
+    0x00, 0x0F, 0x01, 0x80, 0x00, 0x00, 0x0F, 0x80, 0x00, 0x80, 0x0C, 0x95, 0x00, 0x00, 0x3F, 0x80,
+    0x20, 0x04, 0x11, 0x0E, 0x00, 0x3E, 0x04, 0x80, 0x02, 0x02, 0x04, 0x00, 0x1E, 0x81, 0x20, 0x02,
+    0x3E, 0x00, 0x1C, 0x81, 0x22, 0x05, 0x10, 0x00, 0x3F, 0x08, 0x14, 0x22, 0x80, 0x00, 0x00, 0x1C,
+    0x81, 0x2A, 0x03, 0x0C, 0x00, 0x3E, 0x04, 0x80, 0x02, 0x00, 0x3C, 0x85, 0x00, 0x00, 0x23, 0x81,
+    0x24, 0x00, 0x18, 0x80, 0x00, 0x02, 0x22, 0x3E, 0x20, 0x80, 0x00, 0x00, 0x1C, 0x81, 0x2A, 0x00,
+    0x0C, 0x85, 0x00, 0x04, 0x3F, 0x01, 0x06, 0x01, 0x3F, 0x80, 0x00, 0x02, 0x22, 0x3E, 0x20, 0x80,
+    0x00, 0x0C, 0x02, 0x1F, 0x22, 0x20, 0x10, 0x00, 0x02, 0x1F, 0x22, 0x20, 0x10, 0x00, 0x1C, 0x81,
+    0x2A, 0x00, 0x0C, 0x94, 0x00,
+};
+
+// SCR_ERROR_MSG (de): 290 bytes
+const uint8_t SCR_ERROR_MSG_de[290] = {
+    0x80, 0x08, 0xFF, 0x00, 0xFF, 0x00, 0x81, 0x00, 0x06, 0xF0, 0x80, 0x40, 0x20, 0x10, 0x00, 0x80,
+    0x81, 0x40, 0x00, 0x80, 0x80, 0x00, 0x01, 0x40, 0xD0, 0x81, 0x00, 0x01, 0xC0, 0x80, 0x80, 0x40,
+    0x02, 0x80, 0x00, 0x80, 0x81, 0x40, 0x00, 0x80, 0x85, 0x00, 0x00, 0xC0, 0x81, 0x00, 0x02, 0xC0,
+    0x00, 0x80, 0x81, 0x40, 0x00, 0x80, 0x80, 0x00, 0x01, 0x40, 0xD0, 0x81, 0x00, 0x02, 0x40, 0xF0,
+    0x40, 0x81, 0x00, 0x00, 0x80, 0x81, 0x40, 0x03, 0x80, 0x00, 0xC0, 0x80, 0x80, 0x40, 0x02, 0x80,
+    0x00, 0x80, 0x81, 0x40, 0x03, 0x80, 0x00, 0xC0, 0x80, 0x80, 0x40, 0x00, 0x80, 0xAB, 0x00, 0x06,
+    0xC7, 0x40, 0x41, 0x42, 0x84, 0x00, 0x03, 0x81, 0x05, 0x00, 0x01, 0x80, 0x00, 0x02, 0x04, 0x07,
+    0x04, 0x80, 0x00, 0x00, 0x07, 0x81, 0x00, 0x03, 0x07, 0x00, 0x03, 0xC5, 0x80, 0x05, 0x00, 0x01,
+    0x85, 0x00, 0x06, 0x03, 0x04, 0x03, 0x04, 0x03, 0x00, 0x03, 0x81, 0x05, 0x00, 0x01, 0x80, 0x00,
+    0x02, 0x04, 0x07, 0x04, 0x81, 0x00, 0x00, 0x03, 0x80, 0x04, 0x02, 0x02, 0x00, 0x03, 0x81, 0x05,
+    0x02, 0x01, 0x00, 0x07, 0x83, 0x00, 0x00, 0x03, 0x81, 0x05, 0x02, 0x01, 0x00, 0x07, 0x81, 0x00,
+    0x00, 0x07, 0xAB, 0x00, 0x00, 0x1F, 0x81, 0x12, 0x02, 0x0D, 0x00, 0x0E, 0x81, 0x15, 0x03, 0x06,
+    0x00, 0x1F, 0x02, 0x80, 0x01, 0x02, 0x1E, 0x00, 0x0F, 0x80, 0x10, 0x0F, 0x08, 0x1F, 0x00, 0x01,
+    0x0F, 0x11, 0x10, 0x08, 0x00, 0x11, 0x19, 0x15, 0x13, 0x11, 0x00, 0x0E, 0x81, 0x15, 0x03, 0x06,
+    0x00, 0x1F, 0x02, 0x80, 0x01, 0x00, 0x02, 0xCF, 0x00, 0x00, 0x38, 0x81, 0x54, 0x03, 0x18, 0x00,
+    0x7C, 0x08, 0x80, 0x04, 0x00, 0x08, 0x80, 0x00, 0x02, 0x41, 0x7F, 0x40, 0x80, 0x00, 0x00, 0x20,
+    0x81, 0x54, 0x02, 0x78, 0x00, 0x3C, 0x80, 0x40, 0x04, 0x20, 0x7C, 0x00, 0x7F, 0x48, 0x80, 0x44,
+    0x06, 0x38, 0x00, 0x04, 0x3F, 0x44, 0x40, 0x20, 0x80, 0x00, 0x80, 0x60, 0xFF, 0x00, 0xFF, 0x00,
+    0xCA, 0x00,
+};
+
+// SCR_GRID (all languages): 86 bytes
+const uint8_t SCR_GRID_all[86] = {
+    0x80, 0x08, 0xFF, 0x00, 0xBA, 0x00, 0x06, 0x10, 0x28, 0x44, 0x82, 0x44, 0x28, 0x10, 0xFF, 0x00,
+    0xCF, 0x00, 0x04, 0x80, 0x40, 0x20, 0x40, 0x80, 0xA1, 0x00, 0x04, 0x80, 0x40, 0x20, 0x40, 0x80,
+    0xA1, 0x00, 0x04, 0x80, 0x40, 0x20, 0x40, 0x80, 0xA8, 0x00, 0x06, 0x01, 0x02, 0x04, 0x08, 0x04,
+    0x02, 0x01, 0x9F, 0x00, 0x06, 0x01, 0x02, 0x04, 0x08, 0x04, 0x02, 0x01, 0x9F, 0x00, 0x06, 0x01,
+    0x02, 0x04, 0x08, 0x04, 0x02, 0x01, 0xFF, 0x00, 0xCE, 0x00, 0x06, 0x10, 0x28, 0x44, 0x82, 0x44,
+    0x28, 0x10, 0xFF, 0x00, 0xB9, 0x00,
+};
+
+const uint8_t* const SCREENS[2][SCR_COUNT] = {
+    { SCR_WELCOME_en, SCR_TUTORIAL_en, SCR_ERROR_MSG_en, SCR_GRID_all },
+    { SCR_WELCOME_de, SCR_TUTORIAL_de, SCR_ERROR_MSG_de, SCR_GRID_all },
+};
@@ -0,0 +1,23 @@
+/* Generated by scr2c.py on 2026-10-15 23:18:12.596637 */
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <stdint.h>
+#include "languages.h"
+
+// Pre-rendered full screen page images, drawn with DrawImage(0, 0, ...)
+enum ScreenID {
+    SCR_WELCOME = 0,
+    SCR_TUTORIAL = 1,
+    SCR_ERROR_MSG = 2,
+    SCR_GRID = 3,
+    SCR_COUNT
+};
+
+// Screen Table
+extern const uint8_t* const SCREENS[2][SCR_COUNT];
+
+// Helper Macro
+#define GetScreen(id) SCREENS[sysLanguage][id]
+
+#endif // SCREENS_H